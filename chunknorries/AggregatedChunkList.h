@@ -0,0 +1,260 @@
+#pragma once
+#include <vector>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // ChunkList that keeps op-aggregates of every chunk in a segment tree, so the aggregate of any
+    // index range costs two partial chunks plus O(log(chunks)). op has to be associative, identity
+    // its neutral element; it does not have to be commutative or invertible.
+    // Writes through At and operator[] go through a proxy that updates the aggregates.
+    template <typename T, int N, typename Op = std::plus<T>, typename Allocator = Allocator<T>>
+    class AggregatedChunkList {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using const_reference = const value_type&;
+        using list_type = ChunkList<T, N, Allocator>;
+
+        class reference {
+        private:
+            AggregatedChunkList* owner;
+            size_type position;
+
+        public:
+            reference(AggregatedChunkList* list, size_type pos) noexcept : owner(list), position(pos) {}
+
+            operator const_reference() const {
+                return owner->GetElement(position);
+            }
+
+            reference& operator=(const value_type& value) {
+                owner->GetElement(position) = value;
+                owner->UpdateChunk(owner->GetChunkIndex(position));
+                return *this;
+            }
+
+            reference& operator=(const reference& other) {
+                return *this = static_cast<const_reference>(other);
+            }
+        };
+
+    private:
+        list_type list;
+        Op op;
+        value_type identity;
+        std::vector<Chunk<value_type>*> chunks; //directory of the list's chunks
+        std::vector<value_type> tree; //leaves start at tree.size() / 2
+
+    public:
+        explicit AggregatedChunkList(Op operation = Op(), const value_type& neutral = value_type(),
+                                     const Allocator& alloc = Allocator())
+            : list(alloc), op(operation), identity(neutral) {}
+
+        AggregatedChunkList(const AggregatedChunkList& other) = delete;
+
+        AggregatedChunkList& operator=(const AggregatedChunkList& other) = delete;
+
+        int get_size() const noexcept {
+            return list.get_size();
+        }
+
+        bool empty() const noexcept {
+            return list.empty();
+        }
+
+        const list_type& get_list() const noexcept {
+            return list;
+        }
+
+        reference At(size_type pos) {
+            CheckPosition(pos);
+            return reference(this, pos);
+        }
+
+        const_reference At(size_type pos) const {
+            CheckPosition(pos);
+            return GetElement(pos);
+        }
+
+        reference operator[](size_type pos) {
+            return reference(this, pos);
+        }
+
+        const_reference operator[](size_type pos) const {
+            return GetElement(pos);
+        }
+
+        void push_back(const T& value) {
+            list.push_back(value);
+            SyncChunks();
+            SetLeaf(chunks.size() - 1, op(GetLeaf(chunks.size() - 1), value));
+        }
+
+        void pop_back() {
+            list.pop_back();
+            SyncChunks();
+            if (!chunks.empty()) {
+                UpdateChunk(chunks.size() - 1);
+            }
+        }
+
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        void append(InputIt first, InputIt last) {
+            size_type first_changed = chunks.empty() ? 0 : chunks.size() - 1;
+            list.append(first, last);
+            SyncChunks();
+            for (size_type i = first_changed; i < chunks.size(); i++) {
+                UpdateChunk(i);
+            }
+        }
+
+        // inserts and erases shift every later element, so all later chunks are recomputed
+        void insert(size_type pos, const T& value) {
+            if (pos > static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            list.emplace(GetIterator(pos), value);
+            SyncChunks();
+            for (size_type i = GetChunkIndex(pos); i < chunks.size(); i++) {
+                UpdateChunk(i);
+            }
+        }
+
+        void erase(size_type pos) {
+            CheckPosition(pos);
+            list.erase(GetIterator(pos));
+            SyncChunks();
+            for (size_type i = GetChunkIndex(pos); i < chunks.size(); i++) {
+                UpdateChunk(i);
+            }
+        }
+
+        void clear() noexcept {
+            list.clear();
+            chunks.clear();
+            tree.clear();
+        }
+
+        // op-aggregate of the elements in [first, last), identity for an empty range
+        value_type range_aggregate(size_type first, size_type last) const {
+            if (first > last || last > static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            if (first == last) {
+                return identity;
+            }
+            size_type first_chunk = GetChunkIndex(first);
+            size_type last_chunk = GetChunkIndex(last - 1);
+            if (first_chunk == last_chunk) {
+                return FoldSlots(first_chunk, first + list.HeadOffset() - first_chunk * N, last + list.HeadOffset() - first_chunk * N);
+            }
+            value_type head = FoldSlots(first_chunk, first + list.HeadOffset() - first_chunk * N, N);
+            value_type tail = FoldSlots(last_chunk, 0, last + list.HeadOffset() - last_chunk * N);
+            return op(op(head, QueryChunks(first_chunk + 1, last_chunk)), tail);
+        }
+
+        value_type aggregate() const {
+            return chunks.empty() ? identity : QueryChunks(0, chunks.size());
+        }
+
+    private:
+        void CheckPosition(size_type pos) const {
+            if (pos >= static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+        }
+
+        value_type& GetElement(size_type pos) const {
+            size_type slot = pos + list.HeadOffset();
+            return chunks[slot / N]->list[slot % N];
+        }
+
+        size_type GetChunkIndex(size_type pos) const noexcept {
+            return (pos + list.HeadOffset()) / N;
+        }
+
+        // folds the placed elements of a chunk between two slot indices
+        value_type FoldSlots(size_type chunk_index, size_type first_slot, size_type last_slot) const {
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            first_slot = std::max<size_type>(first_slot, chunk->offset);
+            last_slot = std::min<size_type>(last_slot, chunk->offset + chunk->current_size);
+            value_type result = identity;
+            for (size_type i = first_slot; i < last_slot; i++) {
+                result = op(result, chunk->list[i]);
+            }
+            return result;
+        }
+
+        value_type GetLeaf(size_type chunk_index) const {
+            return tree[tree.size() / 2 + chunk_index];
+        }
+
+        void UpdateChunk(size_type chunk_index) {
+            SetLeaf(chunk_index, FoldSlots(chunk_index, 0, N));
+        }
+
+        void SetLeaf(size_type chunk_index, const value_type& value) {
+            size_type node = tree.size() / 2 + chunk_index;
+            tree[node] = value;
+            for (node /= 2; node > 0; node /= 2) {
+                tree[node] = op(tree[2 * node], tree[2 * node + 1]);
+            }
+        }
+
+        // aggregate of the chunks in [first, last), keeping the left-to-right order for non-commutative ops
+        value_type QueryChunks(size_type first, size_type last) const {
+            value_type left = identity;
+            value_type right = identity;
+            size_type leaves = tree.size() / 2;
+            for (first += leaves, last += leaves; first < last; first /= 2, last /= 2) {
+                if (first & 1) {
+                    left = op(left, tree[first++]);
+                }
+                if (last & 1) {
+                    right = op(tree[--last], right);
+                }
+            }
+            return op(left, right);
+        }
+
+        // brings the directory in line with the list; the tree doubles when it runs out of leaves
+        void SyncChunks() {
+            size_type chunk_count = list.size == 0 ? 0 : (list.HeadOffset() + list.size + N - 1) / N;
+            if (chunk_count < chunks.size()) {
+                for (size_type i = chunk_count; i < chunks.size(); i++) {
+                    SetLeaf(i, identity);
+                }
+                chunks.resize(chunk_count);
+                return;
+            }
+            while (chunks.size() < chunk_count) {
+                chunks.push_back(chunks.empty() ? list.start : chunks.back()->next);
+            }
+            size_type leaves = tree.size() / 2;
+            if (chunk_count > leaves) {
+                size_type new_leaves = std::max<size_type>(leaves, 1);
+                while (new_leaves < chunk_count) {
+                    new_leaves *= 2;
+                }
+                std::vector<value_type> new_tree(2 * new_leaves, identity);
+                for (size_type i = 0; i < leaves; i++) {
+                    new_tree[new_leaves + i] = tree[leaves + i];
+                }
+                for (size_type node = new_leaves - 1; node > 0; node--) {
+                    new_tree[node] = op(new_tree[2 * node], new_tree[2 * node + 1]);
+                }
+                tree.swap(new_tree);
+            }
+        }
+
+        typename list_type::const_iterator GetIterator(size_type pos) {
+            if (pos == static_cast<size_type>(list.size)) {
+                return list.cend();
+            }
+            typename list_type::const_iterator iterator = list.cbegin();
+            iterator += pos;
+            return iterator;
+        }
+    };
+}
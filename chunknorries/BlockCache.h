@@ -0,0 +1,274 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace chucknorries {
+    // Allocator for chunk-sized blocks that keeps most calls away from malloc. Blocks are grouped in
+    // power-of-two size classes; every thread has a magazine (free list) per class, a magazine that
+    // grows too long gives half of its blocks to a global depot, and an empty one refills from the
+    // depot before falling back to malloc. Magazines and the depot are bounded in bytes per class, so
+    // large classes keep only a few blocks and anything beyond the bound goes back to the system.
+    // A block freed by a thread other than its owner is pushed on the owner's lock-free remote list,
+    // and the owner takes those blocks back the next time its magazine runs dry. Caches of exited
+    // threads are flushed and handed to new threads.
+    class BlockCache {
+    public:
+        using size_type = std::size_t;
+
+        static constexpr int MinShift = 6; //smallest class holds 64 bytes
+        static constexpr int ClassCount = 15; //largest class holds 1 MiB, bigger blocks go to malloc directly
+        static constexpr int MagazineSize = 32; //blocks per magazine, fewer in classes above MaxMagazineBytes
+        static constexpr size_type MaxMagazineBytes = size_type(256) << 10;
+        static constexpr size_type MaxDepotBytes = size_type(4) << 20; //per class, the rest goes back to the system
+
+    private:
+        static constexpr std::uint32_t Uncached = ClassCount;
+
+        struct ThreadCache;
+
+        // in front of every block; keeps the block aligned like malloc does
+        struct alignas(16) Header {
+            ThreadCache* owner;
+            std::uint32_t size_class;
+        };
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Magazine {
+            FreeBlock* head = nullptr;
+            int count = 0;
+
+            void Push(FreeBlock* block) noexcept {
+                block->next = head;
+                head = block;
+                count++;
+            }
+
+            FreeBlock* Pop() noexcept {
+                FreeBlock* block = head;
+                head = block->next;
+                count--;
+                return block;
+            }
+
+            // moves the first count blocks into a magazine of their own
+            Magazine Split(int split_count) noexcept {
+                Magazine taken;
+                for (int i = 0; i < split_count; i++) {
+                    taken.Push(Pop());
+                }
+                return taken;
+            }
+        };
+
+        struct ThreadCache {
+            Magazine magazines[ClassCount]; //owner thread only
+            std::atomic<FreeBlock*> remote{ nullptr }; //blocks freed by other threads, of any class
+        };
+
+        // releases the thread's cache when the thread exits
+        struct CacheHolder {
+            ThreadCache* cache = nullptr;
+
+            ~CacheHolder() {
+                if (cache != nullptr) {
+                    Instance().RetireCache(cache);
+                    LocalState().exited = true;
+                }
+            }
+        };
+
+        struct ThreadState {
+            ThreadCache* cache;
+            bool exited;
+        };
+
+        std::mutex mutex; //guards the depot and the retired caches
+        std::vector<Magazine> depot[ClassCount];
+        size_type depot_blocks[ClassCount] = {};
+        std::vector<ThreadCache*> retired_caches;
+
+        BlockCache() = default;
+
+    public:
+        BlockCache(const BlockCache& other) = delete;
+
+        BlockCache& operator=(const BlockCache& other) = delete;
+
+        // never destroyed, blocks may still be freed while static objects are torn down
+        static BlockCache& Instance() {
+            static BlockCache* instance = new BlockCache();
+            return *instance;
+        }
+
+        void* allocate(size_type bytes) {
+            std::uint32_t size_class = GetSizeClass(bytes);
+            ThreadCache* cache = size_class == Uncached ? nullptr : GetLocalCache();
+            if (cache == nullptr) {
+                return AllocateFromSystem(size_class == Uncached ? bytes : ClassBytes(size_class), Uncached, nullptr);
+            }
+            Magazine& magazine = cache->magazines[size_class];
+            if (magazine.count == 0) {
+                Refill(cache, size_class);
+            }
+            if (magazine.count == 0) {
+                return AllocateFromSystem(ClassBytes(size_class), size_class, cache);
+            }
+            Header* header = reinterpret_cast<Header*>(magazine.Pop()) - 1;
+            header->owner = cache;
+            return header + 1;
+        }
+
+        void deallocate(void* pointer) noexcept {
+            if (pointer == nullptr) {
+                return;
+            }
+            Header* header = static_cast<Header*>(pointer) - 1;
+            if (header->size_class == Uncached) {
+                std::free(header);
+                return;
+            }
+            FreeBlock* block = static_cast<FreeBlock*>(pointer);
+            ThreadCache* cache = LocalState().exited ? nullptr : LocalState().cache;
+            if (header->owner != cache) {
+                // handed back lazily, the owner collects it when it runs out of blocks
+                ThreadCache* owner = header->owner;
+                block->next = owner->remote.load(std::memory_order_relaxed);
+                while (!owner->remote.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                                            std::memory_order_relaxed)) {}
+                return;
+            }
+            Magazine& magazine = cache->magazines[header->size_class];
+            magazine.Push(block);
+            int length = MagazineLength(header->size_class);
+            if (magazine.count >= 2 * length) {
+                Magazine spilled = magazine.Split(length);
+                std::lock_guard<std::mutex> lock(mutex);
+                PutInDepot(header->size_class, spilled);
+            }
+        }
+
+        // bytes held in the depot for the size class of bytes, for tests and tuning
+        size_type get_depot_bytes(size_type bytes) {
+            std::uint32_t size_class = GetSizeClass(bytes);
+            if (size_class == Uncached) {
+                return 0;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            return depot_blocks[size_class] * ClassBytes(size_class);
+        }
+
+        // blocks a full magazine of the size class holds
+        static int MagazineLength(std::uint32_t size_class) noexcept {
+            size_type length = MaxMagazineBytes / ClassBytes(size_class);
+            return length == 0 ? 1 : length < MagazineSize ? static_cast<int>(length) : MagazineSize;
+        }
+
+    private:
+        static ThreadState& LocalState() noexcept {
+            static thread_local ThreadState state{ nullptr, false };
+            return state;
+        }
+
+        // nullptr once the thread's cache is gone, while thread_local objects are destroyed
+        ThreadCache* GetLocalCache() {
+            ThreadState& state = LocalState();
+            if (state.cache == nullptr && !state.exited) {
+                static thread_local CacheHolder holder;
+                ThreadCache* cache = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!retired_caches.empty()) {
+                        cache = retired_caches.back();
+                        retired_caches.pop_back();
+                    }
+                }
+                state.cache = cache != nullptr ? cache : new ThreadCache();
+                holder.cache = state.cache;
+            }
+            return state.exited ? nullptr : state.cache;
+        }
+
+        static std::uint32_t GetSizeClass(size_type bytes) noexcept {
+            std::uint32_t size_class = 0;
+            while (size_class < ClassCount && ClassBytes(size_class) < bytes) {
+                size_class++;
+            }
+            return size_class;
+        }
+
+        static size_type ClassBytes(std::uint32_t size_class) noexcept {
+            return size_type(1) << (size_class + MinShift);
+        }
+
+        static void* AllocateFromSystem(size_type bytes, std::uint32_t size_class, ThreadCache* owner) {
+            Header* header = static_cast<Header*>(std::malloc(sizeof(Header) + bytes));
+            if (header == nullptr) {
+                throw std::bad_alloc();
+            }
+            header->owner = owner;
+            header->size_class = size_class;
+            return header + 1;
+        }
+
+        // takes back the blocks other threads freed, then a magazine from the depot
+        void Refill(ThreadCache* cache, std::uint32_t size_class) {
+            FreeBlock* block = cache->remote.exchange(nullptr, std::memory_order_acquire);
+            while (block != nullptr) {
+                FreeBlock* next = block->next;
+                cache->magazines[(reinterpret_cast<Header*>(block) - 1)->size_class].Push(block);
+                block = next;
+            }
+            if (cache->magazines[size_class].count > 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!depot[size_class].empty()) {
+                cache->magazines[size_class] = depot[size_class].back();
+                depot[size_class].pop_back();
+                depot_blocks[size_class] -= cache->magazines[size_class].count;
+            }
+        }
+
+        void PutInDepot(std::uint32_t size_class, Magazine magazine) noexcept {
+            if ((depot_blocks[size_class] + magazine.count) * ClassBytes(size_class) <= MaxDepotBytes) {
+                try {
+                    depot[size_class].push_back(magazine);
+                    depot_blocks[size_class] += magazine.count;
+                    return;
+                }
+                catch (...) {}
+            }
+            while (magazine.count > 0) {
+                std::free(reinterpret_cast<Header*>(magazine.Pop()) - 1);
+            }
+        }
+
+        // the cache stays alive, remote frees may still arrive and are collected by the next thread using it
+        void RetireCache(ThreadCache* cache) noexcept {
+            FreeBlock* block = cache->remote.exchange(nullptr, std::memory_order_acquire);
+            while (block != nullptr) {
+                FreeBlock* next = block->next;
+                cache->magazines[(reinterpret_cast<Header*>(block) - 1)->size_class].Push(block);
+                block = next;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::uint32_t i = 0; i < ClassCount; i++) {
+                if (cache->magazines[i].count > 0) {
+                    PutInDepot(i, cache->magazines[i]);
+                    cache->magazines[i] = Magazine();
+                }
+            }
+            try {
+                retired_caches.push_back(cache);
+            }
+            catch (...) {}
+        }
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "SummarizedChunkList.h"
+
+namespace chucknorries {
+    // Blocked Bloom filter over the elements of one chunk, about ten bits per element. Every key sets
+    // Probes bits inside a single 512-bit block, so a lookup touches one cache line.
+    template <typename T, int N, typename Hash = std::hash<T>>
+    struct BloomSummary {
+        static constexpr int BlockWords = 8;
+        static constexpr int Blocks = (N * 10 + 511) / 512;
+        static constexpr int Probes = 6;
+
+        std::array<std::uint64_t, Blocks * BlockWords> bits{};
+
+        // std::hash is the identity for integers on common implementations, so the result is remixed
+        static std::uint64_t HashKey(const T& value) {
+            std::uint64_t hash = static_cast<std::uint64_t>(Hash()(value));
+            hash ^= hash >> 30;
+            hash *= 0xbf58476d1ce4e5b9ULL;
+            hash ^= hash >> 27;
+            hash *= 0x94d049bb133111ebULL;
+            return hash ^ (hash >> 31);
+        }
+
+        void Add(const T& value) {
+            AddHash(HashKey(value));
+        }
+
+        void AddHash(std::uint64_t hash) {
+            std::uint64_t* block = bits.data() + GetBlock(hash) * BlockWords;
+            for (int i = 0; i < Probes; i++) {
+                unsigned bit = (hash >> (i * 9)) & 511;
+                block[bit / 64] |= std::uint64_t(1) << (bit % 64);
+            }
+        }
+
+        bool MayContainHash(std::uint64_t hash) const {
+            const std::uint64_t* block = bits.data() + GetBlock(hash) * BlockWords;
+            for (int i = 0; i < Probes; i++) {
+                unsigned bit = (hash >> (i * 9)) & 511;
+                if ((block[bit / 64] & (std::uint64_t(1) << (bit % 64))) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void Rebuild(const T* values, int count) {
+            bits.fill(0);
+            for (int i = 0; i < count; i++) {
+                Add(values[i]);
+            }
+        }
+
+    private:
+        // the probes use the low 54 bits, the block is picked from the high ones
+        static std::size_t GetBlock(std::uint64_t hash) noexcept {
+            return static_cast<std::size_t>(((hash >> 32) * Blocks) >> 32);
+        }
+    };
+
+    // ChunkList with a Bloom filter per chunk: membership queries only scan the chunks whose filter
+    // does not reject the key
+    template <typename T, int N, typename Hash = std::hash<T>, typename Allocator = Allocator<T>>
+    class BloomChunkList : public SummarizedChunkList<T, N, BloomSummary<T, N, Hash>, Allocator> {
+    private:
+        using base = SummarizedChunkList<T, N, BloomSummary<T, N, Hash>, Allocator>;
+        using filter_type = BloomSummary<T, N, Hash>;
+
+    public:
+        using typename base::value_type;
+        using typename base::size_type;
+
+        using base::base;
+
+        bool contains(const T& value) const {
+            return find(value) >= 0;
+        }
+
+        // position of the first element equal to value, or -1
+        int find(const T& value) const {
+            int position = -1;
+            ForEachCandidate(value, [&](const value_type* values, int count, int first_position) {
+                const value_type* found = std::find(values, values + count, value);
+                if (found != values + count) {
+                    position = first_position + static_cast<int>(found - values);
+                }
+                return position < 0;
+            });
+            return position;
+        }
+
+        size_type count(const T& value) const {
+            size_type count_found = 0;
+            ForEachCandidate(value, [&](const value_type* values, int count, int) {
+                count_found += std::count(values, values + count, value);
+                return true;
+            });
+            return count_found;
+        }
+
+        // number of chunks a lookup of value has to scan
+        size_type count_candidate_chunks(const T& value) const {
+            size_type candidates = 0;
+            ForEachCandidate(value, [&candidates](const value_type*, int, int) {
+                candidates++;
+                return true;
+            });
+            return candidates;
+        }
+
+    private:
+        template <typename Function>
+        void ForEachCandidate(const T& value, Function f) const {
+            std::uint64_t hash = filter_type::HashKey(value);
+            this->for_each_summary([&](const filter_type& filter, const value_type* values, int count, int position) {
+                return !filter.MayContainHash(hash) || f(values, count, position);
+            });
+        }
+    };
+}
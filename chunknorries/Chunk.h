@@ -1,7 +1,22 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <vector>
+#ifdef __cpp_impl_three_way_comparison
+#include <compare>
+#endif
+#include "BlockCache.h"
+#include "RadixKey.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include "WorkStealing.h"
 
 namespace chucknorries {
     template <typename T>
@@ -20,11 +35,14 @@ namespace chucknorries {
         Allocator(const Allocator<T>& other) noexcept = default;
 
         template <class U>
-        Allocator(const Allocator<U>& other) noexcept {}
+        Allocator(const Allocator<U>& other) noexcept : cached(other.uses_block_cache()) {}
 
         ~Allocator() = default;
 
         pointer allocate(size_type n) {
+            if (cached) {
+                return static_cast<pointer>(BlockCache::Instance().allocate(sizeof(value_type) * n));
+            }
             auto p = static_cast<pointer>(malloc(sizeof(value_type) * n));
             if (p)
                 return p;
@@ -34,10 +52,79 @@ namespace chucknorries {
 
         void deallocate(pointer p, size_type n) noexcept {
             (void)n;
+            if (cached) {
+                BlockCache::Instance().deallocate(p);
+                return;
+            }
             free(p);
         }
+
+        bool uses_block_cache() const noexcept {
+            return cached;
+        }
+
+    protected:
+        explicit Allocator(bool use_block_cache) noexcept : cached(use_block_cache) {}
+
+    private:
+        bool cached = false; //kept when converted, so chunks built from a CachingAllocator stay on the cache
+    };
+
+    // Serves chunk storage from the thread's BlockCache, e.g. ChunkList<T, N, CachingAllocator<T>>.
+    // Opt-in, so the default allocator stays plain malloc and visible to sanitizers.
+    template <typename T>
+    class CachingAllocator : public Allocator<T> {
+    public:
+        CachingAllocator() noexcept : Allocator<T>(true) {}
+
+        template <class U>
+        CachingAllocator(const Allocator<U>&) noexcept : Allocator<T>(true) {}
     };
 
+    template <class T, class U>
+    bool operator==(const Allocator<T>& first, const Allocator<U>& second) noexcept {
+        return first.uses_block_cache() == second.uses_block_cache();
+    }
+
+    template <class T, class U>
+    bool operator!=(const Allocator<T>& first, const Allocator<U>& second) noexcept {
+        return !(first == second);
+    }
+
+    // types whose equality is exactly equality of their object representation
+    template <typename ValueType>
+    struct IsMemcmpComparable : std::integral_constant<bool,
+        std::is_integral<ValueType>::value || std::is_enum<ValueType>::value> {};
+
+    template <typename Iterator, typename = void>
+    struct IsInputIterator : std::false_type {};
+
+    template <typename Iterator>
+    struct IsInputIterator<Iterator, typename std::enable_if<std::is_convertible<
+        typename std::iterator_traits<Iterator>::iterator_category, std::input_iterator_tag>::value>::type>
+        : std::true_type {};
+
+    // ranges given by plain pointers to trivially copyable elements are copied with memcpy
+    template <typename Iterator, typename ValueType>
+    struct IsMemcpyRange : std::integral_constant<bool,
+        std::is_pointer<Iterator>::value &&
+        std::is_same<typename std::remove_cv<typename std::remove_pointer<Iterator>::type>::type, ValueType>::value &&
+        std::is_trivially_copyable<ValueType>::value> {};
+
+
+    template <typename ValueType>
+    class IChunkList {
+    public:
+        using pointer = ValueType*;
+        using size_type = std::size_t;
+        using reference = ValueType&;
+
+        virtual ~IChunkList() = default;
+
+        virtual size_t GetSize() const noexcept = 0;
+        virtual reference At(size_type position) = 0;
+        virtual reference operator[](std::ptrdiff_t position) = 0;
+    };
 
     template <typename ValueType>
     class ChunkList_iterator {
@@ -203,7 +290,7 @@ namespace chucknorries {
         }
 
         int GetIndex() {
-            return index;
+            return this->index;
         }
 
         friend bool operator==(const ChunkList_const_iterator<ValueType>& first,
@@ -225,62 +312,62 @@ namespace chucknorries {
         }
 
         ChunkList_const_iterator& operator++() {
-            if (index + 1 == chunk->GetSize()) {
+            if (this->index + 1 == this->chunk->GetSize()) {
                 this->chunk = nullptr;
                 this->value = nullptr;
                 this->index = 0;
                 return *this;
             }
-            this->value = &chunk->At(++index);
+            this->value = &this->chunk->At(++this->index);
             return *this;
         }
 
         ChunkList_const_iterator operator++(int) {
-            if (index + 1 == chunk->GetSize()) {
+            if (this->index + 1 == this->chunk->GetSize()) {
                 return ChunkList_const_iterator();
             }
-            this->value = &chunk->At(++index);
+            this->value = &this->chunk->At(++this->index);
             return *this;
         }
 
         ChunkList_const_iterator& operator--() {
-            if (index - 1 < 0) {
+            if (this->index - 1 < 0) {
                 throw std::exception();
             }
-            this->value = &chunk->At(--index);
+            this->value = &this->chunk->At(--this->index);
             return *this;
         }
 
         ChunkList_const_iterator operator--(int) {
-            if (index - 1 < 0) {
+            if (this->index - 1 < 0) {
                 throw std::exception();
             }
-            this->value = &chunk->At(--index);
+            this->value = &this->chunk->At(--this->index);
             return *this;
         }
 
         ChunkList_const_iterator operator+(const difference_type& difference) const {
-            return ChunkList_const_iterator(&chunk->At(index + difference), index + difference, chunk);
+            return ChunkList_const_iterator(&this->chunk->At(this->index + difference), this->index + difference, this->chunk);
         }
 
         ChunkList_const_iterator& operator+=(const difference_type& difference) {
             this->index += difference;
-            this->value = &chunk->At(index);
+            this->value = &this->chunk->At(this->index);
             return *this;
         }
 
         ChunkList_const_iterator operator-(const difference_type& difference) const {
-            return ChunkList_const_iterator(&chunk->At(index - difference), index - difference, chunk);
+            return ChunkList_const_iterator(&this->chunk->At(this->index - difference), this->index - difference, this->chunk);
         }
 
         ChunkList_const_iterator& operator-=(const difference_type& difference) {
             this->index -= difference;
-            this->value = &chunk->At(index);
+            this->value = &this->chunk->At(this->index);
             return *this;
         }
 
         reference operator[](const difference_type& n) {
-            return chunk[n];
+            return this->chunk->At(this->index + n);
         }
 
         friend bool operator<(const ChunkList_const_iterator<ValueType>& first,
@@ -304,18 +391,6 @@ namespace chucknorries {
         }
     };
 
-    template <typename ValueType>
-    class IChunkList {
-    public:
-        using pointer = ValueType*;
-        using size_type = std::size_t;
-        using reference = ValueType&;
-
-        virtual size_t GetSize() const noexcept = 0;
-        virtual reference At(size_type position) = 0;
-        virtual reference operator[](std::ptrdiff_t position) = 0;
-    };
-
     template <typename ValueType>
     class Chunk : IChunkList<ValueType> {
     public:
@@ -324,11 +399,10 @@ namespace chucknorries {
         using pointer = ValueType*;
         using size_type = std::size_t;
         using value_type = ValueType;
-        using reference = ValueType&;
-        using difference_type = std::ptrdiff_t;
 
         int size = 0; //size of all chunk
         int current_size = 0; //current size with placed elements
+        int offset = 0; //index of the first placed element, only the head chunk has it non-zero
         pointer list = nullptr;
         Allocator<value_type> allocator;
         Chunk* prev = nullptr;
@@ -386,9 +460,109 @@ namespace chucknorries {
         int size = 0;
         Chunk<value_type>* start = nullptr;
 
+        template <typename, int, typename>
+        friend class ChunkList;
+
+        template <typename, int, typename, typename>
+        friend class SummarizedChunkList;
+
+        template <typename, int, typename, typename>
+        friend class AggregatedChunkList;
+
+        template <typename, int, int, typename>
+        friend class StripedChunkList;
+
     public:
+        // Fills private chunks for one thread without any synchronization. merge links the chunks of
+        // several builders into one list afterwards.
+        class Builder {
+        private:
+            Chunk<value_type>* first = nullptr;
+            Chunk<value_type>* last = nullptr;
+            int size = 0;
+            Allocator allocator;
+
+            friend class ChunkList;
+
+        public:
+            explicit Builder(const Allocator& alloc = Allocator()) : allocator(alloc) {}
+
+            Builder(const Builder& other) = delete;
+
+            Builder& operator=(const Builder& other) = delete;
+
+            Builder(Builder&& other) noexcept : first(other.first), last(other.last), size(other.size), allocator(other.allocator) {
+                other.first = nullptr;
+                other.last = nullptr;
+                other.size = 0;
+            }
+
+            Builder& operator=(Builder&& other) noexcept {
+                if (this != &other) {
+                    clear();
+                    first = other.first;
+                    last = other.last;
+                    size = other.size;
+                    allocator = other.allocator;
+                    other.first = nullptr;
+                    other.last = nullptr;
+                    other.size = 0;
+                }
+                return *this;
+            }
+
+            ~Builder() {
+                clear();
+            }
+
+            size_type get_size() const noexcept {
+                return size;
+            }
+
+            bool empty() const noexcept {
+                return size == 0;
+            }
+
+            void push_back(const T& value) {
+                emplace_back(value);
+            }
+
+            void push_back(T&& value) {
+                emplace_back(std::move(value));
+            }
+
+            template <typename... Args>
+            reference emplace_back(Args&&... args) {
+                if (last == nullptr || last->current_size == N) {
+                    Chunk<value_type>* new_chunk = new Chunk<value_type>(N, allocator);
+                    new_chunk->prev = last;
+                    (last == nullptr ? first : last->next) = new_chunk;
+                    last = new_chunk;
+                }
+                pointer slot = last->list + last->current_size;
+                ::new (static_cast<void*>(slot)) value_type(std::forward<Args>(args)...);
+                last->current_size++;
+                size++;
+                return *slot;
+            }
+
+            void clear() noexcept {
+                while (first != nullptr) {
+                    Chunk<value_type>* temp_pointer = first;
+                    first = first->next;
+                    for (int i = 0; i < temp_pointer->current_size; i++) {
+                        temp_pointer->list[i].~value_type();
+                    }
+                    temp_pointer->allocator.deallocate(temp_pointer->list, temp_pointer->size);
+                    delete temp_pointer;
+                }
+                last = nullptr;
+                size = 0;
+            }
+        };
 
-        ChunkList() : start(new Chunk<value_type>(N)) {}
+
+        ChunkList() : start(new Chunk<value_type>(N, Allocator())) {}
 
         explicit ChunkList(const Allocator& alloc) : start(new Chunk<value_type>(N, alloc)) {}
 
@@ -396,12 +570,11 @@ namespace chucknorries {
             return size;
         }
 
-        ChunkList(size_type count, const T& value = T(), const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N))
+        ChunkList(size_type count, const T& value = T(), const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N, alloc))
         {
             Chunk<value_type>* temp_pointer = start;
             bool flag = false;
             while (size < count) {
-                temp_pointer->allocator = alloc;
                 for (int j = 0; j < N; j++) {
                     temp_pointer->list[j] = value;
                     temp_pointer->current_size++;
@@ -421,12 +594,11 @@ namespace chucknorries {
             }
         }
 
-        explicit ChunkList(size_type count, const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N))
+        explicit ChunkList(size_type count, const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N, alloc))
         {
             Chunk<value_type>* temp_pointer = start;
             bool flag = false;
             while (size < count) {
-                temp_pointer->allocator = alloc;
                 for (int j = 0; j < N; j++) {
                     temp_pointer->list[j] = value_type();
                     temp_pointer->current_size++;
@@ -446,49 +618,34 @@ namespace chucknorries {
             }
         }
 
-        ChunkList(const ChunkList& other) : start(new Chunk<value_type>(N)) {
-            Chunk<value_type>* other_list = other.start;
-            Chunk<value_type>* this_list = start;
-            size = other.size;
-            while (other_list != nullptr) {
-                this_list->current_size = other_list->current_size;
-                this_list->list = other_list->CopyElements();
-                this_list->next = new Chunk<value_type>(N);
-                Chunk<value_type>* temp_pointer = this_list;
-                this_list = this_list->next;
-                this_list->prev = temp_pointer;
-                other_list = other_list->next;
-            }
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        ChunkList(InputIt first, InputIt last, const Allocator& alloc = Allocator()) : start(new Chunk<value_type>(N, alloc))
+        {
+            append(first, last);
         }
 
+        ChunkList(const ChunkList& other) : ChunkList(other, other.get_allocator()) {}
+
         ChunkList(const ChunkList& other, const Allocator& alloc) : start(new Chunk<value_type>(N, alloc)) {
-            Chunk<value_type>* other_list = other.start;
-            Chunk<value_type>* this_list = start;
-            size = other.size;
-            while (other_list != nullptr) {
-                this_list->current_size = other_list->current_size;
-                this_list->list = other_list->CopyElements();
-                this_list->next = new Chunk<value_type>(N, alloc);
-                Chunk<value_type>* temp_pointer = this_list;
-                this_list = this_list->next;
-                this_list->prev = temp_pointer;
-                other_list = other_list->next;
-            }
-        }
-
-        ChunkList(ChunkList&& other) {
-            size = std::move(other.size);
-            start = std::move(other.start);
-            other.clear();
+            AppendChain(other.start, other.size, [](pointer values) { return values; });
+        }
+
+        ChunkList(ChunkList&& other) noexcept : size(other.size), start(other.start) {
+            other.size = 0;
+            other.start = nullptr;
         }
 
         ChunkList(ChunkList&& other, const Allocator& alloc) {
-            this = ChunkList(other);
-            Chunk<value_type>* temp_pointer = this->start;
-            while (temp_pointer != nullptr) {
-                temp_pointer->allocator = alloc;
-                temp_pointer = temp_pointer->next;
+            if (alloc == other.get_allocator()) {
+                size = other.size;
+                start = other.start;
+                other.size = 0;
+                other.start = nullptr;
+                return;
             }
+            start = new Chunk<value_type>(N, alloc);
+            AppendChain(other.start, other.size, [](pointer values) { return std::make_move_iterator(values); });
+            other.clear();
         }
 
         ~ChunkList() {
@@ -496,37 +653,77 @@ namespace chucknorries {
         }
 
         ChunkList& operator=(const ChunkList& other) {
-            this = new ChunkList(other);
+            if (this != &other) {
+                ChunkList copy(other);
+                swap(copy);
+            }
             return *this;
         }
 
-        ChunkList& operator=(ChunkList&& other) {
-            size = std::move(other.size);
-            start = std::move(other.start);
-            other.clear();
+        ChunkList& operator=(ChunkList&& other) noexcept {
+            if (this != &other) {
+                clear();
+                size = other.size;
+                start = other.start;
+                other.size = 0;
+                other.start = nullptr;
+            }
             return *this;
         }
 
         void assign(size_type count, const T& value) {
-            if (count > 0) {
-                clear();
-                for (int i = 0; i < count; i++) {
-                    push_back(value);
+            clear();
+            Chunk<value_type>* temp_pointer = ReserveBack(count);
+            try {
+                while (count > 0) {
+                    size_type batch = std::min<size_type>(count, temp_pointer->size - temp_pointer->offset - temp_pointer->current_size);
+                    std::uninitialized_fill_n(temp_pointer->list + temp_pointer->offset + temp_pointer->current_size, batch, value);
+                    temp_pointer->current_size += batch;
+                    size += batch;
+                    count -= batch;
+                    temp_pointer = temp_pointer->next;
                 }
-                size = count;
             }
+            catch (...) {
+                clear();
+                throw;
+            }
+        }
+
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        void assign(InputIt first, InputIt last) {
+            clear();
+            append(first, last);
         }
 
         allocator_type get_allocator() const noexcept {
-            return start->allocator;
+            return start == nullptr ? allocator_type() : allocator_type(start->allocator);
+        }
+
+        // Links the chunks of the builders into one list, in builder order, and leaves the builders empty.
+        // A builder's chain is relinked as it is when the elements in front of it fill whole chunks;
+        // otherwise its elements are shifted into the partly filled tail in front of it, reusing its chunks.
+        template <typename... Builders>
+        static ChunkList merge(Builder& first, Builders&... rest) {
+            Builder* builders[] = { &first, &rest... };
+            return MergeBuilders(builders, 1 + sizeof...(rest));
+        }
+
+        static ChunkList merge(std::vector<Builder>& builders) {
+            std::vector<Builder*> pointers;
+            pointers.reserve(builders.size());
+            for (auto& builder : builders) {
+                pointers.push_back(&builder);
+            }
+            return MergeBuilders(pointers.data(), pointers.size());
         }
 
         reference At(size_type pos) override {
             if (pos < 0 || pos >= max_size()) {
                 throw std::out_of_range("Position is out of range!");
             }
-            int chunk_number = pos / N;
-            int value_number = pos % N;
+            int chunk_number = (pos + HeadOffset()) / N;
+            int value_number = (pos + HeadOffset()) % N;
             Chunk<value_type>* temp_pointer = start;
             for (int i = 0; i < chunk_number; i++) {
                 temp_pointer = temp_pointer->next;
@@ -539,8 +736,8 @@ namespace chucknorries {
             if (pos < 0 || pos >= max_size()) {
                 throw std::out_of_range("Position is out of range!");
             }
-            int chunk_number = pos / N;
-            int value_number = pos % N;
+            int chunk_number = (pos + HeadOffset()) / N;
+            int value_number = (pos + HeadOffset()) % N;
             Chunk<value_type>* temp_pointer = start;
             for (int i = 0; i < chunk_number; i++) {
                 temp_pointer = temp_pointer->next;
@@ -549,8 +746,8 @@ namespace chucknorries {
         }
 
         reference operator[](difference_type pos) override {
-            int chunk_number = pos / N;
-            int value_number = pos % N;
+            int chunk_number = (pos + HeadOffset()) / N;
+            int value_number = (pos + HeadOffset()) % N;
             Chunk<value_type>* temp_pointer = start;
             for (int i = 0; i < chunk_number; i++) {
                 temp_pointer = temp_pointer->next;
@@ -560,8 +757,8 @@ namespace chucknorries {
 
         const_reference operator[](difference_type pos) const
         {
-            int chunk_number = pos / N;
-            int value_number = pos % N;
+            int chunk_number = (pos + HeadOffset()) / N;
+            int value_number = (pos + HeadOffset()) % N;
             Chunk<value_type>* temp_pointer = start;
             for (int i = 0; i < chunk_number; i++) {
                 temp_pointer = temp_pointer->next;
@@ -571,14 +768,14 @@ namespace chucknorries {
 
         reference front() {
             if (size > 0)
-                return start->list[0];
+                return start->list[start->offset];
             else 
                 throw std::runtime_error("ChunkList is empty!");
         }
 
         const_reference front() const {
             if (size > 0) {
-                static_cast<reference>(start->list[0]);
+                return start->list[start->offset];
             }
             else throw std::runtime_error("ChunkList is empty!");
         }
@@ -591,7 +788,7 @@ namespace chucknorries {
             while (temp_pointer->next != nullptr) {
                 temp_pointer = temp_pointer->next;
             }
-            return temp_pointer->list[temp_pointer->current_size - 1];
+            return temp_pointer->list[temp_pointer->offset + temp_pointer->current_size - 1];
         }
 
         const_reference back() const {
@@ -602,7 +799,7 @@ namespace chucknorries {
             while (temp_pointer->next != nullptr) {
                 temp_pointer = temp_pointer->next;
             }
-            return const_cast<reference>(temp_pointer->list[temp_pointer->current_size - 1]);
+            return const_cast<reference>(temp_pointer->list[temp_pointer->offset + temp_pointer->current_size - 1]);
         }
 
         iterator begin() noexcept {
@@ -644,7 +841,7 @@ namespace chucknorries {
         }
 
         size_type max_size() const noexcept {
-            size_type value_number = size % N;
+            size_type value_number = (size + HeadOffset()) % N;
             return (value_number == 0 ? size : size + N - value_number);
         }
 
@@ -653,96 +850,71 @@ namespace chucknorries {
             while (current_chunk != nullptr) {
                 Chunk<value_type>* temp_pointer = current_chunk;
                 current_chunk = current_chunk->next;
-                delete temp_pointer;
+                ReleaseChunk(temp_pointer);
             }
             start = nullptr;
             size = 0;
         }
 
         iterator insert(const_iterator pos, const T& value) {
-            if (pos == cend())
-                return end();
-            int index = pos.GetIndex();
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            ChunkList_iterator<value_type> iterator(&temp_pointer->
-                list[temp_pointer->current_size - 1], size - 1, this);
-            if (size < max_size()) {
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    At(size - i) = At(size - i - 1);
-                }
-                size++;
-            }
-            else {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_chunk = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_chunk;
-                size++;
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    At(size - i - 1) = At(size - i - 2);
-                }
-            }
-            At(index) = value;
-            temp_pointer->current_size++;
-            return ChunkList_iterator<value_type>(&At(index), index, this);
+            return emplace(pos, value);
         }
 
         iterator insert(const_iterator pos, T&& value) {
-            if (pos == cend())
-                return end();
-            int index = pos.GetIndex();
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            ChunkList_iterator<value_type> iterator(&temp_pointer->
-                list[temp_pointer->current_size - 1], size - 1, this);
-            if (size < max_size()) {
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    At(size - i) = At(size - i - 1);
-                }
-                size++;
+            return emplace(pos, std::move(value));
+        }
+
+        // the element is built before anything moves, so args may refer to elements of the list
+        template <typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args) {
+            if (pos == cend()) {
+                emplace_back(std::forward<Args>(args)...);
+                return ChunkList_iterator<value_type>(&At(size - 1), size - 1, this);
             }
-            else {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_chunk = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_chunk;
-                size++;
-                for (int i = 0; iterator >= pos; i++, iterator--) {
-                    At(size - i - 1) = At(size - i - 2);
-                }
+            int index = pos.GetIndex();
+            value_type value(std::forward<Args>(args)...);
+            emplace_back(std::move(back()));
+            ShiftRight(index);
+            pointer slot = &At(index);
+            *slot = std::move(value);
+            return ChunkList_iterator<value_type>(slot, index, this);
+        }
+
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            int index = (pos == cend()) ? size : pos.GetIndex();
+            InsertRange(index, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+            if (index >= size) {
+                return end();
             }
-            At(index) = std::move(value);
-            temp_pointer->current_size++;
             return ChunkList_iterator<value_type>(&At(index), index, this);
         }
 
+        // moves the elements after pos one slot to the left, chunk by chunk, and drops the last one
         iterator erase(const_iterator pos) {
             int index = pos.GetIndex();
-            if (index + 1 == size) {
-                size--;
-                return ChunkList_iterator<value_type>();
-            }
-            for (int i = index + 1; index < size; i++) {
-                At(i - 1) = At(i);
-            }
+            int slot = index + HeadOffset();
             Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
+            for (int i = 0; i < slot / N; i++) {
                 temp_pointer = temp_pointer->next;
             }
-            if (size == max_size() - N + 1) {
-                temp_pointer = temp_pointer->prev;
-                delete temp_pointer->next;
-                temp_pointer->next = nullptr;
+            int local = slot % N;
+            while (true) {
+                pointer values = temp_pointer->list;
+                int chunk_end = temp_pointer->offset + temp_pointer->current_size;
+                std::move(values + local + 1, values + chunk_end, values + local);
+                Chunk<value_type>* next = temp_pointer->next;
+                if (next == nullptr || next->current_size == 0) {
+                    break;
+                }
+                values[chunk_end - 1] = std::move(next->list[next->offset]);
+                temp_pointer = next;
+                local = 0;
             }
-            else {
-                temp_pointer->current_size--;
+            pop_back();
+            if (index == size) {
+                return end();
             }
-            size--;
             return ChunkList_iterator<value_type>(&At(index), index, this);
         }
 
@@ -775,69 +947,100 @@ namespace chucknorries {
         }
 
         void push_back(const T& value) {
-            if (start == nullptr) {
-                start = new Chunk<value_type>(N);
-            }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            if (temp_pointer->current_size == temp_pointer->size) {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_pointer = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_pointer;
-            }
-            temp_pointer->list[temp_pointer->current_size] = value;
-            temp_pointer->current_size++;
-            size++;
+            emplace_back(value);
         }
 
         void push_back(T&& value) {
-            if (start == nullptr) {
-                start = new Chunk<value_type>(N);
-            }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
-            if (temp_pointer->current_size == temp_pointer->size) {
-                temp_pointer->next = new Chunk<value_type>(N);
-                Chunk<value_type>* prev_pointer = temp_pointer;
-                temp_pointer = temp_pointer->next;
-                temp_pointer->prev = prev_pointer;
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            Chunk<value_type>* temp_pointer = FindLastChunk();
+            if (temp_pointer->offset + temp_pointer->current_size == temp_pointer->size) {
+                temp_pointer = ReserveBack(1);
             }
-            temp_pointer->list[temp_pointer->current_size] = std::move(value);
+            pointer slot = temp_pointer->list + temp_pointer->offset + temp_pointer->current_size;
+            ::new (static_cast<void*>(slot)) value_type(std::forward<Args>(args)...);
             temp_pointer->current_size++;
             size++;
+            return *slot;
+        }
+
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        void append(InputIt first, InputIt last) {
+            AppendRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
         }
 
         void pop_back() {
-            if (start == nullptr) {
+            if (start == nullptr || size == 0) {
                 throw std::runtime_error("ChunkList is empty!");
                 return;
             }
-            Chunk<value_type>* temp_pointer = start;
-            while (temp_pointer->next != nullptr) {
-                temp_pointer = temp_pointer->next;
-            }
+            Chunk<value_type>* temp_pointer = FindLastChunk();
             temp_pointer->current_size--;
+            temp_pointer->list[temp_pointer->offset + temp_pointer->current_size].~value_type();
             size--;
+            if (temp_pointer->current_size == 0 && temp_pointer->prev != nullptr) {
+                temp_pointer->prev->next = nullptr;
+                ReleaseChunk(temp_pointer);
+            }
         }
 
         void push_front(const T& value) {
-            insert(cbegin(), value);
+            emplace_front(value);
         }
 
         void push_front(T&& value) {
-            insert(cbegin(), std::move(value));
+            emplace_front(std::move(value));
+        }
+
+        // the head chunk is filled from its back, so a new head chunk is only needed when its first slot is taken
+        template <typename... Args>
+        reference emplace_front(Args&&... args) {
+            if (start == nullptr) {
+                start = new Chunk<value_type>(N, Allocator());
+            }
+            if (start->offset == 0 && (start->current_size > 0 || start->next != nullptr)) {
+                Chunk<value_type>* new_chunk = new Chunk<value_type>(N, start->allocator);
+                new_chunk->offset = N;
+                new_chunk->next = start;
+                start->prev = new_chunk;
+                start = new_chunk;
+            }
+            else if (start->current_size == 0) {
+                start->offset = N;
+            }
+            pointer slot = start->list + start->offset - 1;
+            ::new (static_cast<void*>(slot)) value_type(std::forward<Args>(args)...);
+            start->offset--;
+            start->current_size++;
+            size++;
+            return *slot;
         }
 
         void pop_front() {
-            erase(cbegin());
+            if (start == nullptr || size == 0) {
+                throw std::runtime_error("ChunkList is empty!");
+            }
+            start->list[start->offset].~value_type();
+            start->offset++;
+            start->current_size--;
+            size--;
+            if (start->current_size == 0) {
+                if (start->next != nullptr) {
+                    Chunk<value_type>* old_start = start;
+                    start = start->next;
+                    start->prev = nullptr;
+                    ReleaseChunk(old_start);
+                }
+                else {
+                    start->offset = 0;
+                }
+            }
         }
 
-        void swap(ChunkList& other) {
+        void swap(ChunkList& other) noexcept {
             Chunk<value_type>* tmp_start;
             int tmp_size;
             tmp_start = other.start;
@@ -848,24 +1051,1043 @@ namespace chucknorries {
             this->size = tmp_size;
         }
 
-        friend bool operator==(const ChunkList<U, N, Alloc>& lhs,
-            const ChunkList<U, N, Alloc>& rhs) {
+        template <typename Function>
+        void for_each_chunk(Function f) {
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                if (temp_pointer->current_size > 0) {
+                    f(temp_pointer->list + temp_pointer->offset, static_cast<size_type>(temp_pointer->current_size));
+                }
+            }
+        }
+
+        template <typename Function>
+        void for_each_chunk(Function f) const {
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                if (temp_pointer->current_size > 0) {
+                    f(static_cast<const value_type*>(temp_pointer->list + temp_pointer->offset),
+                        static_cast<size_type>(temp_pointer->current_size));
+                }
+            }
+        }
+
+        // The following run the widest SIMD kernels the CPU supports over every chunk, see SimdKernels.h.
+        // Element types other than signed 32- and 64-bit integers, float and double fall back to scalar loops.
+        value_type sum() const {
+            const SimdKernelTable<value_type>& kernels = GetSimdKernels<value_type>();
+            value_type result = value_type();
+            for_each_chunk([&](const value_type* values, size_type count) { result += kernels.sum(values, count); });
+            return result;
+        }
+
+        value_type min_value() const {
+            if (size == 0) {
+                throw std::runtime_error("ChunkList is empty!");
+            }
+            const SimdKernelTable<value_type>& kernels = GetSimdKernels<value_type>();
+            value_type result = front();
+            for_each_chunk([&](const value_type* values, size_type count) {
+                value_type chunk_min = kernels.min(values, count);
+                result = ScalarKernels<value_type>::Smaller(result, chunk_min);
+            });
+            return result;
+        }
+
+        value_type max_value() const {
+            if (size == 0) {
+                throw std::runtime_error("ChunkList is empty!");
+            }
+            const SimdKernelTable<value_type>& kernels = GetSimdKernels<value_type>();
+            value_type result = front();
+            for_each_chunk([&](const value_type* values, size_type count) {
+                value_type chunk_max = kernels.max(values, count);
+                result = ScalarKernels<value_type>::Larger(result, chunk_max);
+            });
+            return result;
+        }
+
+        size_type count_equal(const value_type& value) const {
+            const SimdKernelTable<value_type>& kernels = GetSimdKernels<value_type>();
+            size_type result = 0;
+            for_each_chunk([&](const value_type* values, size_type count) { result += kernels.count_equal(values, count, value); });
+            return result;
+        }
+
+        // position of the first element equal to value, or -1
+        int find_first(const value_type& value) const {
+            const SimdKernelTable<value_type>& kernels = GetSimdKernels<value_type>();
+            int position = 0;
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                size_type index = kernels.find_first(temp_pointer->list + temp_pointer->offset, temp_pointer->current_size, value);
+                if (index < static_cast<size_type>(temp_pointer->current_size)) {
+                    return position + static_cast<int>(index);
+                }
+                position += temp_pointer->current_size;
+            }
+            return -1;
+        }
+
+        bool any_greater(const value_type& value) const {
+            const SimdKernelTable<value_type>& kernels = GetSimdKernels<value_type>();
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                if (kernels.any_greater(temp_pointer->list + temp_pointer->offset, temp_pointer->current_size, value)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // calls f on every element; contiguous groups of chunks are handed out to the pool's workers
+        template <typename Function>
+        void parallel_for_each(Function f, ThreadPool& pool = ThreadPool::Default()) {
+            std::vector<Chunk<value_type>*> chunks = CollectChunks();
+            pool.parallel_for(chunks.size(), [&chunks, &f](size_type first, size_type last) {
+                for (size_type i = first; i < last; i++) {
+                    pointer data = chunks[i]->list + chunks[i]->offset;
+                    for (int j = 0; j < chunks[i]->current_size; j++) {
+                        f(data[j]);
+                    }
+                }
+            });
+        }
+
+        // same as parallel_for_each, but chunks are scheduled one at a time with work stealing,
+        // which keeps the workers busy when the cost per element varies a lot
+        template <typename Function>
+        void parallel_for_each_stealing(Function f, ThreadPool& pool = ThreadPool::Default()) {
+            std::vector<Chunk<value_type>*> chunks = CollectChunks();
+            WorkStealingExecutor(pool).parallel_for(chunks.size(), [&chunks, &f](size_type first, size_type last) {
+                for (size_type i = first; i < last; i++) {
+                    pointer data = chunks[i]->list + chunks[i]->offset;
+                    for (int j = 0; j < chunks[i]->current_size; j++) {
+                        f(data[j]);
+                    }
+                }
+            });
+        }
+
+        // sorts every chunk on its own and then merges the sorted chunks into freshly allocated ones
+        template <typename Compare = std::less<value_type>>
+        void sort(Compare comp = Compare()) {
+            SortChunks(comp, false, nullptr);
+        }
+
+        template <typename Compare = std::less<value_type>>
+        void stable_sort(Compare comp = Compare()) {
+            SortChunks(comp, true, nullptr);
+        }
+
+        // same as sort, but the chunks are sorted in parallel and the output is split into one range per worker,
+        // each filled by its own k-way merge
+        template <typename Compare = std::less<value_type>>
+        void parallel_sort(Compare comp = Compare(), ThreadPool& pool = ThreadPool::Default()) {
+            SortChunks(comp, false, &pool);
+        }
+
+        template <typename Compare = std::less<value_type>>
+        void parallel_stable_sort(Compare comp = Compare(), ThreadPool& pool = ThreadPool::Default()) {
+            SortChunks(comp, true, &pool);
+        }
+
+        // LSD radix sort on an arithmetic key, one byte per pass. Every pass builds a histogram for each worker's
+        // group of chunks in parallel and then scatters the elements stably into freshly allocated chunks.
+        // Passes where all keys share the same byte are skipped.
+        template <typename KeyExtractor = RadixIdentity>
+        void radix_sort(KeyExtractor key = KeyExtractor(), ThreadPool& pool = ThreadPool::Default()) {
+            using key_traits = RadixKey<typename std::decay<decltype(key(std::declval<const value_type&>()))>::type>;
+            if (size < 2) {
+                return;
+            }
+            std::vector<Chunk<value_type>*> source_chunks;
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                source_chunks.push_back(temp_pointer);
+            }
+            std::vector<Chunk<value_type>*> buffers[2];
+            try {
+                for (auto& buffer : buffers) {
+                    buffer.reserve((size + N - 1) / N);
+                    for (int i = 0; i < (size + N - 1) / N; i++) {
+                        buffer.push_back(new Chunk<value_type>(N, start->allocator));
+                    }
+                }
+            }
+            catch (...) {
+                for (auto& buffer : buffers) {
+                    for (auto chunk : buffer) {
+                        ReleaseChunk(chunk);
+                    }
+                }
+                throw;
+            }
+
+            const std::vector<Chunk<value_type>*>* current = &source_chunks;
+            int current_offset = HeadOffset();
+            int target = 0;
+            int part_count = std::min<int>(pool.get_size() + 1, (size + N - 1) / N);
+            std::vector<std::array<size_type, 256>> counts(part_count);
+            auto element = [&current, &current_offset](size_type position) -> reference {
+                position += current_offset;
+                return (*current)[position / N]->list[position % N];
+            };
+
+            for (size_type shift = 0; shift < sizeof(typename key_traits::type) * 8; shift += 8) {
+                pool.parallel_for(part_count, [&](size_type first, size_type last) {
+                    for (size_type part = first; part < last; part++) {
+                        counts[part].fill(0);
+                        for (size_type i = size * part / part_count; i < size * (part + 1) / part_count; i++) {
+                            counts[part][(key_traits::Get(key(element(i))) >> shift) & 255]++;
+                        }
+                    }
+                });
+
+                size_type running = 0;
+                bool single_digit = false;
+                for (int digit = 0; digit < 256; digit++) {
+                    size_type digit_total = 0;
+                    for (int part = 0; part < part_count; part++) {
+                        size_type count = counts[part][digit];
+                        counts[part][digit] = running;
+                        running += count;
+                        digit_total += count;
+                    }
+                    single_digit = single_digit || digit_total == static_cast<size_type>(size);
+                }
+                if (single_digit) {
+                    continue;
+                }
+
+                const std::vector<Chunk<value_type>*>& output = buffers[target];
+                pool.parallel_for(part_count, [&](size_type first, size_type last) {
+                    for (size_type part = first; part < last; part++) {
+                        for (size_type i = size * part / part_count; i < size * (part + 1) / part_count; i++) {
+                            reference value = element(i);
+                            size_type position = counts[part][(key_traits::Get(key(value)) >> shift) & 255]++;
+                            ::new (static_cast<void*>(output[position / N]->list + position % N)) value_type(std::move(value));
+                            value.~value_type();
+                        }
+                    }
+                });
+                current = &buffers[target];
+                current_offset = 0;
+                target ^= 1;
+            }
+
+            if (current == &source_chunks) {
+                for (auto& buffer : buffers) {
+                    for (auto chunk : buffer) {
+                        ReleaseChunk(chunk);
+                    }
+                }
+                return;
+            }
+            const std::vector<Chunk<value_type>*>& result = *current;
+            for (size_type i = 0; i < result.size(); i++) {
+                result[i]->current_size = i + 1 < result.size() ? N : size - i * N;
+                result[i]->prev = i > 0 ? result[i - 1] : nullptr;
+                result[i]->next = i + 1 < result.size() ? result[i + 1] : nullptr;
+            }
+            for (auto chunk : source_chunks) {
+                chunk->current_size = 0;
+                ReleaseChunk(chunk);
+            }
+            for (auto chunk : buffers[target]) {
+                ReleaseChunk(chunk);
+            }
+            start = result[0];
+        }
+
+        // replaces every element with f(element), in parallel like parallel_for_each
+        template <typename Function>
+        void parallel_transform(Function f, ThreadPool& pool = ThreadPool::Default()) {
+            parallel_for_each([&f](reference value) { value = f(value); }, pool);
+        }
+
+        // folds every chunk in parallel and then the chunk results in order, so op has to be associative
+        template <typename U, typename BinaryOp>
+        U parallel_reduce(U init, BinaryOp op, ThreadPool& pool = ThreadPool::Default()) const {
+            std::vector<Chunk<value_type>*> chunks = CollectChunks();
+            std::vector<U> partials(chunks.size(), init);
+            pool.parallel_for(chunks.size(), [&](size_type first, size_type last) {
+                for (size_type i = first; i < last; i++) {
+                    const value_type* values = chunks[i]->list + chunks[i]->offset;
+                    U partial = values[0];
+                    for (int j = 1; j < chunks[i]->current_size; j++) {
+                        partial = op(std::move(partial), values[j]);
+                    }
+                    partials[i] = std::move(partial);
+                }
+            });
+            for (auto& partial : partials) {
+                init = op(std::move(init), std::move(partial));
+            }
+            return init;
+        }
+
+        // replaces every element with the op-sum of all elements up to and including it
+        template <typename BinaryOp = std::plus<value_type>>
+        void inclusive_scan(BinaryOp op = BinaryOp(), ThreadPool& pool = ThreadPool::Default()) {
+            ScanInPlace(op, static_cast<const value_type*>(nullptr), pool);
+        }
+
+        // replaces every element with the op-sum of init and all elements before it
+        template <typename BinaryOp = std::plus<value_type>>
+        void exclusive_scan(const value_type& init, BinaryOp op = BinaryOp(), ThreadPool& pool = ThreadPool::Default()) {
+            ScanInPlace(op, &init, pool);
+        }
+
+        // fills output with the inclusive scan of transform(element), this list is left untouched
+        template <typename U, typename OutputAllocator, typename BinaryOp, typename UnaryOp>
+        void transform_inclusive_scan(ChunkList<U, N, OutputAllocator>& output, BinaryOp op, UnaryOp transform,
+                                      ThreadPool& pool = ThreadPool::Default()) const {
+            TransformInto(output, transform, pool);
+            output.ScanInPlace(op, static_cast<const U*>(nullptr), pool);
+        }
+
+        // fills output with the exclusive scan of transform(element), e.g. an offset table over record lengths
+        template <typename U, typename OutputAllocator, typename BinaryOp, typename UnaryOp>
+        void transform_exclusive_scan(ChunkList<U, N, OutputAllocator>& output, const U& init, BinaryOp op, UnaryOp transform,
+                                      ThreadPool& pool = ThreadPool::Default()) const {
+            TransformInto(output, transform, pool);
+            output.ScanInPlace(op, &init, pool);
+        }
+
+        friend bool operator==(const ChunkList& lhs, const ChunkList& rhs) {
             if (lhs.size != rhs.size) {
                 return false;
             }
-            for (int i = 0; i < lhs.size; i++) {
-                if (lhs.At(i) != rhs.At(i)) {
+            return ForEachSpanPair(lhs, rhs, [](const value_type* first, const value_type* second, int count) {
+                return EqualSpans(first, second, count, IsMemcmpComparable<value_type>());
+            });
+        }
+
+        friend bool operator!=(const ChunkList& lhs, const ChunkList& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const ChunkList& lhs, const ChunkList& rhs) {
+            return Compare(lhs, rhs) < 0;
+        }
+
+        friend bool operator<=(const ChunkList& lhs, const ChunkList& rhs) {
+            return Compare(lhs, rhs) <= 0;
+        }
+
+        friend bool operator>(const ChunkList& lhs, const ChunkList& rhs) {
+            return Compare(lhs, rhs) > 0;
+        }
+
+        friend bool operator>=(const ChunkList& lhs, const ChunkList& rhs) {
+            return Compare(lhs, rhs) >= 0;
+        }
+
+#ifdef __cpp_impl_three_way_comparison
+        friend std::weak_ordering operator<=>(const ChunkList& lhs, const ChunkList& rhs) {
+            return Compare(lhs, rhs) <=> 0;
+        }
+#endif
+
+        // lexicographical comparison, returns a negative number, zero or a positive number
+        static int Compare(const ChunkList& lhs, const ChunkList& rhs) {
+            int result = 0;
+            ForEachSpanPair(lhs, rhs, [&result](const value_type* first, const value_type* second, int count) {
+                result = CompareSpans(first, second, count, IsMemcmpComparable<value_type>());
+                return result == 0;
+            });
+            if (result != 0) {
+                return result;
+            }
+            return lhs.size < rhs.size ? -1 : (lhs.size > rhs.size ? 1 : 0);
+        }
+
+    private:
+        // walks both lists chunk by chunk and hands f the longest runs that are contiguous in both of them,
+        // stopping as soon as f returns false
+        template <typename Function>
+        static bool ForEachSpanPair(const ChunkList& lhs, const ChunkList& rhs, Function f) {
+            Chunk<value_type>* lhs_chunk = lhs.start;
+            Chunk<value_type>* rhs_chunk = rhs.start;
+            int lhs_index = 0;
+            int rhs_index = 0;
+            int remaining = std::min(lhs.size, rhs.size);
+            while (remaining > 0) {
+                while (lhs_index == lhs_chunk->current_size) {
+                    lhs_chunk = lhs_chunk->next;
+                    lhs_index = 0;
+                }
+                while (rhs_index == rhs_chunk->current_size) {
+                    rhs_chunk = rhs_chunk->next;
+                    rhs_index = 0;
+                }
+                int count = std::min(remaining, std::min(lhs_chunk->current_size - lhs_index,
+                    rhs_chunk->current_size - rhs_index));
+                if (!f(lhs_chunk->list + lhs_chunk->offset + lhs_index, rhs_chunk->list + rhs_chunk->offset + rhs_index, count)) {
                     return false;
                 }
+                lhs_index += count;
+                rhs_index += count;
+                remaining -= count;
             }
-
             return true;
         }
 
-        template <class U, int N, class Alloc>
-        friend bool operator!=(const ChunkList<U, N, Alloc>& lhs,
-            const ChunkList<U, N, Alloc>& rhs) {
-            return !(lhs == rhs);
+        static bool EqualSpans(const value_type* first, const value_type* second, int count, std::true_type) {
+            return std::memcmp(first, second, count * sizeof(value_type)) == 0;
+        }
+
+        static bool EqualSpans(const value_type* first, const value_type* second, int count, std::false_type) {
+            return std::equal(first, first + count, second);
+        }
+
+        static int CompareSpans(const value_type* first, const value_type* second, int count, std::true_type) {
+            if (std::memcmp(first, second, count * sizeof(value_type)) == 0) {
+                return 0;
+            }
+            return CompareSpans(first, second, count, std::false_type());
+        }
+
+        static int CompareSpans(const value_type* first, const value_type* second, int count, std::false_type) {
+            for (int i = 0; i < count; i++) {
+                if (first[i] < second[i]) {
+                    return -1;
+                }
+                if (second[i] < first[i]) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+
+        template <typename Compare>
+        void SortChunks(Compare& comp, bool stable, ThreadPool* pool) {
+            std::vector<Chunk<value_type>*> chunks = CollectChunks();
+            auto sort_chunks = [&chunks, &comp, stable](size_type first, size_type last) {
+                for (size_type i = first; i < last; i++) {
+                    pointer data = chunks[i]->list + chunks[i]->offset;
+                    if (stable) {
+                        std::stable_sort(data, data + chunks[i]->current_size, comp);
+                    }
+                    else {
+                        std::sort(data, data + chunks[i]->current_size, comp);
+                    }
+                }
+            };
+            if (pool != nullptr) {
+                pool->parallel_for(chunks.size(), sort_chunks);
+            }
+            else {
+                sort_chunks(0, chunks.size());
+            }
+            if (chunks.size() > 1) {
+                MergeChunks(chunks, comp, pool);
+            }
+        }
+
+        // Merges the sorted chunks into a new chain of full chunks. Elements that compare equal are taken
+        // from the earlier chunk first, so the merge keeps the order of a stable per-chunk sort.
+        // With a pool the output is cut into one range per worker by splitters sampled from the chunks,
+        // and each worker runs its own k-way merge.
+        template <typename Compare>
+        void MergeChunks(const std::vector<Chunk<value_type>*>& chunks, Compare& comp, ThreadPool* pool) {
+            int run_count = chunks.size();
+            std::vector<pointer> runs(run_count);
+            std::vector<int> run_sizes(run_count);
+            for (int j = 0; j < run_count; j++) {
+                runs[j] = chunks[j]->list + chunks[j]->offset;
+                run_sizes[j] = chunks[j]->current_size;
+            }
+
+            std::vector<Chunk<value_type>*> output((size + N - 1) / N, nullptr);
+            try {
+                for (auto& chunk : output) {
+                    chunk = new Chunk<value_type>(N, start->allocator);
+                }
+            }
+            catch (...) {
+                for (auto chunk : output) {
+                    if (chunk != nullptr) {
+                        ReleaseChunk(chunk);
+                    }
+                }
+                throw;
+            }
+
+            int part_count = pool != nullptr ? std::min<int>(pool->get_size() + 1, size) : 1;
+            // bounds[p][j] is the index in run j where part p starts
+            std::vector<std::vector<int>> bounds(part_count + 1, std::vector<int>(run_count, 0));
+            bounds[part_count] = run_sizes;
+            if (part_count > 1) {
+                struct Sample {
+                    int run;
+                    int position;
+                };
+                auto precedes = [&runs, &comp](const Sample& first, const Sample& second) {
+                    const value_type& x = runs[first.run][first.position];
+                    const value_type& y = runs[second.run][second.position];
+                    if (comp(x, y)) {
+                        return true;
+                    }
+                    if (comp(y, x)) {
+                        return false;
+                    }
+                    return first.run != second.run ? first.run < second.run : first.position < second.position;
+                };
+                int sample_count = part_count * 32;
+                std::vector<Sample> samples;
+                samples.reserve(sample_count);
+                int run = 0;
+                int run_begin = 0;
+                for (int i = 0; i < sample_count; i++) {
+                    int position = static_cast<long long>(size) * i / sample_count;
+                    while (position >= run_begin + run_sizes[run]) {
+                        run_begin += run_sizes[run];
+                        run++;
+                    }
+                    samples.push_back({ run, position - run_begin });
+                }
+                std::sort(samples.begin(), samples.end(), precedes);
+                pool->parallel_for(part_count - 1, [&](size_type first, size_type last) {
+                    for (size_type part = first + 1; part <= last; part++) {
+                        const Sample& splitter = samples[sample_count * part / part_count];
+                        const value_type& value = runs[splitter.run][splitter.position];
+                        for (int j = 0; j < run_count; j++) {
+                            if (j < splitter.run) {
+                                bounds[part][j] = std::upper_bound(runs[j], runs[j] + run_sizes[j], value, comp) - runs[j];
+                            }
+                            else if (j > splitter.run) {
+                                bounds[part][j] = std::lower_bound(runs[j], runs[j] + run_sizes[j], value, comp) - runs[j];
+                            }
+                            else {
+                                bounds[part][j] = splitter.position;
+                            }
+                        }
+                    }
+                });
+            }
+
+            auto merge_parts = [&](size_type first, size_type last) {
+                for (size_type part = first; part < last; part++) {
+                    size_type position = 0;
+                    for (int j = 0; j < run_count; j++) {
+                        position += bounds[part][j];
+                    }
+                    MergePart(runs, bounds[part], bounds[part + 1], output, position, comp);
+                }
+            };
+            if (pool != nullptr) {
+                pool->parallel_for(part_count, merge_parts);
+            }
+            else {
+                merge_parts(0, part_count);
+            }
+
+            for (size_type i = 0; i < output.size(); i++) {
+                output[i]->current_size = i + 1 < output.size() ? N : size - i * N;
+                output[i]->prev = i > 0 ? output[i - 1] : nullptr;
+                output[i]->next = i + 1 < output.size() ? output[i + 1] : nullptr;
+            }
+            Chunk<value_type>* current_chunk = start;
+            while (current_chunk != nullptr) {
+                Chunk<value_type>* temp_pointer = current_chunk;
+                current_chunk = current_chunk->next;
+                ReleaseChunk(temp_pointer);
+            }
+            start = output[0];
+        }
+
+        // k-way merge of runs[j][begin[j], end[j]) into the output slots starting at position
+        template <typename Compare>
+        static void MergePart(const std::vector<pointer>& runs, const std::vector<int>& begin, const std::vector<int>& end,
+            const std::vector<Chunk<value_type>*>& output, size_type position, Compare& comp) {
+            std::vector<int> cursor(begin);
+            auto later = [&runs, &cursor, &comp](int first, int second) {
+                const value_type& x = runs[first][cursor[first]];
+                const value_type& y = runs[second][cursor[second]];
+                if (comp(y, x)) {
+                    return true;
+                }
+                if (comp(x, y)) {
+                    return false;
+                }
+                return first > second;
+            };
+            std::vector<int> heap;
+            for (int j = 0; j < static_cast<int>(runs.size()); j++) {
+                if (cursor[j] < end[j]) {
+                    heap.push_back(j);
+                }
+            }
+            std::make_heap(heap.begin(), heap.end(), later);
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                int j = heap.back();
+                pointer slot = output[position / N]->list + position % N;
+                ::new (static_cast<void*>(slot)) value_type(std::move(runs[j][cursor[j]]));
+                position++;
+                cursor[j]++;
+                if (cursor[j] < end[j]) {
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+                else {
+                    heap.pop_back();
+                }
+            }
+        }
+
+        // scans every chunk locally in parallel, combines the chunk totals in order and then adds
+        // the carried prefix to every chunk in parallel; init == nullptr means an inclusive scan
+        template <typename BinaryOp>
+        void ScanInPlace(BinaryOp& op, const value_type* init, ThreadPool& pool) {
+            std::vector<Chunk<value_type>*> chunks = CollectChunks();
+            pool.parallel_for(chunks.size(), [&](size_type first, size_type last) {
+                for (size_type i = first; i < last; i++) {
+                    pointer values = chunks[i]->list + chunks[i]->offset;
+                    for (int j = 1; j < chunks[i]->current_size; j++) {
+                        values[j] = op(values[j - 1], values[j]);
+                    }
+                }
+            });
+
+            // carries[i] is what precedes chunk i; an inclusive scan has nothing before the first chunk
+            std::vector<value_type> carries;
+            carries.reserve(chunks.size());
+            size_type first_carried = init == nullptr ? 1 : 0;
+            if (init != nullptr && !chunks.empty()) {
+                carries.push_back(*init);
+            }
+            for (size_type i = 1; i < chunks.size(); i++) {
+                const value_type& total = chunks[i - 1]->list[chunks[i - 1]->offset + chunks[i - 1]->current_size - 1];
+                carries.push_back(carries.empty() ? total : op(carries.back(), total));
+            }
+
+            pool.parallel_for(chunks.size(), [&](size_type first, size_type last) {
+                for (size_type i = std::max(first, first_carried); i < last; i++) {
+                    pointer values = chunks[i]->list + chunks[i]->offset;
+                    const value_type& carry = carries[i - first_carried];
+                    if (init == nullptr) {
+                        for (int j = 0; j < chunks[i]->current_size; j++) {
+                            values[j] = op(carry, values[j]);
+                        }
+                        continue;
+                    }
+                    for (int j = chunks[i]->current_size - 1; j > 0; j--) {
+                        values[j] = op(carry, values[j - 1]);
+                    }
+                    values[0] = carry;
+                }
+            });
+        }
+
+        // replaces the content of output with transform(element) for every element, constructed in parallel
+        template <typename U, typename OutputAllocator, typename UnaryOp>
+        void TransformInto(ChunkList<U, N, OutputAllocator>& output, UnaryOp& transform, ThreadPool& pool) const {
+            output.clear();
+            if (size == 0) {
+                return;
+            }
+            std::vector<Chunk<value_type>*> source_chunks;
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                source_chunks.push_back(temp_pointer);
+            }
+            std::vector<Chunk<U>*> output_chunks;
+            for (Chunk<U>* temp_pointer = output.ReserveBack(size); temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                output_chunks.push_back(temp_pointer);
+            }
+
+            int source_offset = HeadOffset();
+            try {
+                pool.parallel_for(output_chunks.size(), [&](size_type first, size_type last) {
+                    for (size_type i = first; i < last; i++) {
+                        size_type count = std::min<size_type>(N, size - i * N);
+                        for (size_type j = 0; j < count; j++) {
+                            size_type position = i * N + j + source_offset;
+                            ::new (static_cast<void*>(output_chunks[i]->list + j)) U(transform(source_chunks[position / N]->list[position % N]));
+                            output_chunks[i]->current_size++;
+                        }
+                    }
+                });
+            }
+            catch (...) {
+                output.clear();
+                throw;
+            }
+            output.size = size;
+        }
+
+        std::vector<Chunk<value_type>*> CollectChunks() const {
+            std::vector<Chunk<value_type>*> chunks;
+            for (Chunk<value_type>* temp_pointer = start; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                if (temp_pointer->current_size > 0) {
+                    chunks.push_back(temp_pointer);
+                }
+            }
+            return chunks;
+        }
+
+        int HeadOffset() const noexcept {
+            return start == nullptr ? 0 : start->offset;
+        }
+
+        Chunk<value_type>* FindLastChunk() {
+            if (start == nullptr) {
+                start = new Chunk<value_type>(N, Allocator());
+            }
+            Chunk<value_type>* temp_pointer = start;
+            while (temp_pointer->next != nullptr) {
+                temp_pointer = temp_pointer->next;
+            }
+            return temp_pointer;
+        }
+
+        // splices the chains of count builders into one list, leaving the builders empty
+        static ChunkList MergeBuilders(Builder* const* builders, size_type count) {
+            ChunkList result(count == 0 ? Allocator() : builders[0]->allocator);
+            Chunk<value_type>* tail = nullptr;
+            for (size_type i = 0; i < count; i++) {
+                Builder& builder = *builders[i];
+                if (builder.size == 0) {
+                    continue;
+                }
+                if (tail == nullptr) {
+                    result.ReleaseChunk(result.start);
+                    result.start = builder.first;
+                    tail = builder.last;
+                }
+                else if (tail->current_size == N) {
+                    tail->next = builder.first;
+                    builder.first->prev = tail;
+                    tail = builder.last;
+                }
+                else {
+                    tail = result.ShiftChain(tail, builder.first);
+                }
+                result.size += builder.size;
+                builder.first = nullptr;
+                builder.last = nullptr;
+                builder.size = 0;
+            }
+            return result;
+        }
+
+        // appends chain behind the partly filled tail; every element moves down into the slot the shift
+        // frees for it, so the chain's own chunks are reused and only its last one can become empty.
+        // Returns the new last chunk.
+        Chunk<value_type>* ShiftChain(Chunk<value_type>* tail, Chunk<value_type>* chain) {
+            tail->next = chain;
+            chain->prev = tail;
+            Chunk<value_type>* target = tail;
+            int target_count = tail->current_size;
+            for (Chunk<value_type>* source = chain; source != nullptr; source = source->next) {
+                for (int i = 0; i < source->current_size; i++) {
+                    if (target_count == N) {
+                        target = target->next;
+                        target_count = 0;
+                    }
+                    if (target == tail) {
+                        ::new (static_cast<void*>(tail->list + target_count)) value_type(std::move(source->list[i]));
+                        tail->current_size++;
+                    }
+                    else {
+                        target->list[target_count] = std::move(source->list[i]);
+                    }
+                    target_count++;
+                }
+            }
+            // the slots behind the last written one only hold moved-from elements
+            Chunk<value_type>* rest = target->next;
+            target->next = nullptr;
+            if (target != tail) {
+                for (int i = target_count; i < target->current_size; i++) {
+                    target->list[i].~value_type();
+                }
+                target->current_size = target_count;
+            }
+            while (rest != nullptr) {
+                Chunk<value_type>* temp_pointer = rest;
+                rest = rest->next;
+                ReleaseChunk(temp_pointer);
+            }
+            return target;
+        }
+
+        // links enough empty chunks after the last one to hold count more elements
+        // and returns the chunk the first of them goes to
+        Chunk<value_type>* ReserveBack(size_type count) {
+            Chunk<value_type>* last_chunk = FindLastChunk();
+            size_type free_slots = last_chunk->size - last_chunk->offset - last_chunk->current_size;
+            if (count <= free_slots) {
+                return last_chunk;
+            }
+            size_type chunk_count = (count - free_slots + N - 1) / N;
+            Chunk<value_type>* first_new = new Chunk<value_type>(N, last_chunk->allocator);
+            Chunk<value_type>* temp_pointer = first_new;
+            try {
+                for (size_type i = 1; i < chunk_count; i++) {
+                    temp_pointer->next = new Chunk<value_type>(N, last_chunk->allocator);
+                    temp_pointer->next->prev = temp_pointer;
+                    temp_pointer = temp_pointer->next;
+                }
+            }
+            catch (...) {
+                while (first_new != nullptr) {
+                    temp_pointer = first_new->next;
+                    ReleaseChunk(first_new);
+                    first_new = temp_pointer;
+                }
+                throw;
+            }
+            last_chunk->next = first_new;
+            first_new->prev = last_chunk;
+            return free_slots > 0 ? last_chunk : first_new;
+        }
+
+        // a throwing element constructor leaves the list as it was before the call
+        template <typename InputIt>
+        void AppendRange(InputIt first, InputIt last, std::input_iterator_tag) {
+            size_type old_size = size;
+            Chunk<value_type>* temp_pointer = FindLastChunk();
+            try {
+                for (; first != last; ++first) {
+                    if (temp_pointer->offset + temp_pointer->current_size == temp_pointer->size) {
+                        temp_pointer->next = new Chunk<value_type>(N, temp_pointer->allocator);
+                        temp_pointer->next->prev = temp_pointer;
+                        temp_pointer = temp_pointer->next;
+                    }
+                    ::new (static_cast<void*>(temp_pointer->list + temp_pointer->offset + temp_pointer->current_size)) value_type(*first);
+                    temp_pointer->current_size++;
+                    size++;
+                }
+            }
+            catch (...) {
+                Truncate(old_size);
+                throw;
+            }
+        }
+
+        template <typename ForwardIt>
+        void AppendRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+            size_type old_size = size;
+            size_type count = std::distance(first, last);
+            Chunk<value_type>* temp_pointer = ReserveBack(count);
+            try {
+                FillReserved(temp_pointer, first, count);
+            }
+            catch (...) {
+                Truncate(old_size);
+                throw;
+            }
+        }
+
+        // appends the count elements of the chain at source, reserving all the chunks they need at once;
+        // make_iterator turns a pointer into a source chunk into the iterator the elements are built from
+        template <typename MakeIterator>
+        void AppendChain(Chunk<value_type>* source, size_type count, MakeIterator make_iterator) {
+            size_type old_size = size;
+            Chunk<value_type>* temp_pointer = ReserveBack(count);
+            try {
+                for (; source != nullptr; source = source->next) {
+                    temp_pointer = FillReserved(temp_pointer, make_iterator(source->list + source->offset), source->current_size);
+                }
+            }
+            catch (...) {
+                Truncate(old_size);
+                throw;
+            }
+        }
+
+        // builds count elements in the free slots from chunk on, going on into the chunks ReserveBack
+        // linked after it. Returns the chunk the last element went to
+        template <typename ForwardIt>
+        Chunk<value_type>* FillReserved(Chunk<value_type>* chunk, ForwardIt first, size_type count) {
+            while (count > 0) {
+                if (chunk->offset + chunk->current_size == chunk->size) {
+                    chunk = chunk->next;
+                }
+                size_type batch = std::min<size_type>(count, chunk->size - chunk->offset - chunk->current_size);
+                first = FillChunk(chunk, first, batch, IsMemcpyRange<ForwardIt, value_type>());
+                size += batch;
+                count -= batch;
+            }
+            return chunk;
+        }
+
+        // current_size counts every element as soon as it is built, so a throw leaves nothing untracked
+        template <typename ForwardIt>
+        ForwardIt FillChunk(Chunk<value_type>* chunk, ForwardIt first, size_type count, std::false_type) {
+            for (size_type i = 0; i < count; i++, ++first) {
+                ::new (static_cast<void*>(chunk->list + chunk->offset + chunk->current_size)) value_type(*first);
+                chunk->current_size++;
+            }
+            return first;
+        }
+
+        template <typename ForwardIt>
+        ForwardIt FillChunk(Chunk<value_type>* chunk, ForwardIt first, size_type count, std::true_type) {
+            if (count > 0) {
+                std::memcpy(chunk->list + chunk->offset + chunk->current_size, first, count * sizeof(value_type));
+                chunk->current_size += count;
+            }
+            return first + count;
+        }
+
+        // a single-pass range has to be read before its length is known
+        template <typename InputIt>
+        void InsertRange(int index, InputIt first, InputIt last, std::input_iterator_tag) {
+            std::vector<value_type> values(first, last);
+            InsertRange(index, std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()),
+                std::random_access_iterator_tag());
+        }
+
+        // reserves count slots at the back and builds them from the new elements that land behind the old
+        // back and from the old back elements, then shifts the rest of the tail right by count and assigns
+        // the new elements to the gap. Positions below are counted in slots from the beginning of the head chunk
+        template <typename ForwardIt>
+        void InsertRange(int index, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+            size_type count = std::distance(first, last);
+            size_type tail_count = size - index;
+            if (count == 0) {
+                return;
+            }
+            if (tail_count == 0) {
+                AppendRange(first, last, std::forward_iterator_tag());
+                return;
+            }
+            size_type old_size = size;
+            size_type moved = std::min(count, tail_count); //old elements that go to the new slots
+            ForwardIt middle = std::next(first, moved);
+            Chunk<value_type>* temp_pointer = ReserveBack(count);
+            try {
+                temp_pointer = FillReserved(temp_pointer, middle, count - moved);
+                size_type slot = old_size - moved + HeadOffset();
+                Chunk<value_type>* source = FindSlotChunk(slot);
+                for (size_type left = moved; left > 0; source = source->next) {
+                    size_type batch = std::min<size_type>(left, N - slot % N);
+                    temp_pointer = FillReserved(temp_pointer, std::make_move_iterator(source->list + slot % N), batch);
+                    slot += batch;
+                    left -= batch;
+                }
+            }
+            catch (...) {
+                Truncate(old_size);
+                throw;
+            }
+
+            int to = old_size - 1 + HeadOffset();
+            int from = to - count;
+            Chunk<value_type>* to_chunk = FindSlotChunk(to);
+            Chunk<value_type>* from_chunk = FindSlotChunk(from < 0 ? 0 : from);
+            for (size_type i = moved; i < tail_count; i++) {
+                to_chunk->list[to % N] = std::move(from_chunk->list[from % N]);
+                if (to-- % N == 0) {
+                    to_chunk = to_chunk->prev;
+                }
+                if (from-- % N == 0) {
+                    from_chunk = from_chunk->prev;
+                }
+            }
+
+            int slot = index + HeadOffset();
+            Chunk<value_type>* gap_chunk = FindSlotChunk(slot);
+            for (; first != middle; ++first, ++slot) {
+                if (slot % N == 0 && slot != index + HeadOffset()) {
+                    gap_chunk = gap_chunk->next;
+                }
+                gap_chunk->list[slot % N] = *first;
+            }
+        }
+
+        Chunk<value_type>* FindSlotChunk(size_type slot) {
+            Chunk<value_type>* temp_pointer = start;
+            for (size_type i = 0; i < slot / N; i++) {
+                temp_pointer = temp_pointer->next;
+            }
+            return temp_pointer;
+        }
+
+        // moves the elements at [index, size - 3] one slot to the right, going chunk by chunk from the back;
+        // the last slot already holds the old back element that emplace appended.
+        // positions below are counted in slots from the beginning of the head chunk
+        void ShiftRight(int index) {
+            Chunk<value_type>* temp_pointer = FindLastChunk();
+            index += HeadOffset();
+            int last = size - 2 + HeadOffset();
+            if (last > index && (last + 1) % N == 0) {
+                temp_pointer = temp_pointer->prev;
+            }
+            int chunk_begin = last / N * N;
+            while (last > index) {
+                int first = std::max(index + 1, chunk_begin + 1);
+                std::move_backward(temp_pointer->list + (first - 1 - chunk_begin),
+                    temp_pointer->list + (last - chunk_begin), temp_pointer->list + (last - chunk_begin + 1));
+                if (index < chunk_begin) {
+                    temp_pointer->list[0] = std::move(temp_pointer->prev->list[N - 1]);
+                }
+                last = chunk_begin - 1;
+                chunk_begin -= N;
+                temp_pointer = temp_pointer->prev;
+            }
+        }
+
+        // drops everything from position new_size on, releasing the chunks left empty
+        void Truncate(size_type new_size) {
+            if (new_size == 0) {
+                clear();
+                return;
+            }
+            size_type last_slot = new_size - 1 + HeadOffset();
+            Chunk<value_type>* temp_pointer = start;
+            for (size_type i = 0; i < last_slot / N; i++) {
+                temp_pointer = temp_pointer->next;
+            }
+            int kept_size = last_slot % N + 1 - temp_pointer->offset;
+            for (int i = kept_size; i < temp_pointer->current_size; i++) {
+                temp_pointer->list[temp_pointer->offset + i].~value_type();
+            }
+            temp_pointer->current_size = kept_size;
+            Chunk<value_type>* next_chunk = temp_pointer->next;
+            temp_pointer->next = nullptr;
+            while (next_chunk != nullptr) {
+                temp_pointer = next_chunk->next;
+                ReleaseChunk(next_chunk);
+                next_chunk = temp_pointer;
+            }
+            size = new_size;
+        }
+
+        void ReleaseChunk(Chunk<value_type>* chunk) noexcept {
+            for (int i = 0; i < chunk->current_size; i++) {
+                chunk->list[chunk->offset + i].~value_type();
+            }
+            chunk->allocator.deallocate(chunk->list, chunk->size);
+            delete chunk;
+        }
+    };
+}
+
+namespace std {
+    template <typename T, int N, typename Allocator>
+    struct hash<chucknorries::ChunkList<T, N, Allocator>> {
+        size_t operator()(const chucknorries::ChunkList<T, N, Allocator>& list) const {
+            size_t seed = list.get_size();
+            list.for_each_chunk([&seed](const T* data, size_t count) {
+                seed = HashSpan(seed, data, count, chucknorries::IsMemcmpComparable<T>());
+            });
+            return seed;
+        }
+
+    private:
+        // the seed is carried element by element, so the result does not depend on how the list is split into chunks
+        static size_t HashSpan(size_t seed, const T* data, size_t count, std::true_type) {
+            for (size_t i = 0; i < count; i++) {
+                seed = (seed ^ static_cast<size_t>(data[i])) * 1099511628211ULL;
+            }
+            return seed;
+        }
+
+        static size_t HashSpan(size_t seed, const T* data, size_t count, std::false_type) {
+            hash<T> hasher;
+            for (size_t i = 0; i < count; i++) {
+                seed ^= hasher(data[i]) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+            }
+            return seed;
         }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,622 @@
+#include "BlockCache.h"
+#include "BloomChunkList.h"
+#include "Chunk.h"
+#include "ChunkHashMap.h"
+#include "ChunkQueue.h"
+#include "ConcurrentChunkList.h"
+#include "SortedChunkList.h"
+#include "SpscChunkQueue.h"
+#include "StripedChunkList.h"
+#include "ZonedChunkList.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace chucknorries;
+
+template <typename Function>
+double MeasureMilliseconds(Function f) {
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int main(int argc, char** argv) {
+    // element count of the sort and scaling benchmarks, e.g. 1000000000 on a large machine
+    const int sort_count = argc > 1 ? std::stoi(argv[1]) : 10000000;
+
+    // Skewed Parallel For Each Benchmark
+    {
+        const int count = 4000000;
+        ChunkList<int, 1024> list;
+        std::vector<int> values(count);
+        for (int i = 0; i < count; i++) {
+            values[i] = i;
+        }
+        list.append(values.begin(), values.end());
+
+        // the first tenth of the list is a hundred times more expensive than the rest
+        auto work = [count](int value) {
+            int rounds = value < count / 10 ? 400 : 4;
+            double x = value;
+            for (int i = 0; i < rounds; i++) {
+                x = std::sqrt(x + i);
+            }
+            return x;
+        };
+        std::atomic<long long> checksum(0);
+        auto consume = [&work, &checksum](int value) {
+            if (work(value) < 0) {
+                checksum++;
+            }
+        };
+
+        double static_time = MeasureMilliseconds([&] { list.parallel_for_each(consume); });
+        double stealing_time = MeasureMilliseconds([&] { list.parallel_for_each_stealing(consume); });
+
+        std::cout << "skewed for_each, " << ThreadPool::Default().get_size() + 1 << " threads: static "
+            << static_time << " ms, work stealing " << stealing_time << " ms" << std::endl;
+    }
+    // Uniform Parallel For Each Benchmark
+    {
+        std::vector<int> values(sort_count);
+        for (int i = 0; i < sort_count; i++) {
+            values[i] = i;
+        }
+        ChunkList<int, 1024> list(values.begin(), values.end());
+
+        // the same cost for every element, so the speedup only depends on the thread count
+        auto work = [](int value) {
+            double x = value;
+            for (int i = 0; i < 8; i++) {
+                x = std::sqrt(x + i);
+            }
+            return x;
+        };
+        std::atomic<long long> checksum(0);
+        auto consume = [&work, &checksum](int value) {
+            if (work(value) < 0) {
+                checksum++;
+            }
+        };
+
+        double serial_time = MeasureMilliseconds([&] {
+            list.for_each_chunk([&consume](const int* chunk_values, std::size_t count) {
+                for (std::size_t i = 0; i < count; i++) {
+                    consume(chunk_values[i]);
+                }
+            });
+        });
+        std::cout << "uniform for_each of " << sort_count << " ints: 1 thread " << serial_time << " ms" << std::endl;
+
+        unsigned core_count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned thread_count = 2; thread_count <= core_count; thread_count++) {
+            // the calling thread works as well
+            ThreadPool pool(thread_count - 1);
+            double parallel_time = MeasureMilliseconds([&] { list.parallel_for_each(consume, pool); });
+
+            std::cout << "uniform parallel_for_each of " << sort_count << " ints: " << thread_count << " threads "
+                << parallel_time << " ms, speedup " << serial_time / parallel_time << std::endl;
+        }
+    }
+    // Radix Sort Benchmark
+    {
+        auto run_sorts = [sort_count](const char* name, const auto& values) {
+            using value_type = typename std::decay<decltype(values)>::type::value_type;
+            ChunkList<value_type, 1024> comparison_list(values.begin(), values.end());
+            ChunkList<value_type, 1024> parallel_list(values.begin(), values.end());
+            ChunkList<value_type, 1024> radix_list(values.begin(), values.end());
+
+            double comparison_time = MeasureMilliseconds([&] { comparison_list.sort(); });
+            double parallel_time = MeasureMilliseconds([&] { parallel_list.parallel_sort(); });
+            double radix_time = MeasureMilliseconds([&] { radix_list.radix_sort(); });
+
+            std::cout << "sort of " << sort_count << " " << name << ", " << ThreadPool::Default().get_size() + 1
+                << " threads: sort " << comparison_time << " ms, parallel_sort " << parallel_time << " ms, radix_sort "
+                << radix_time << " ms" << std::endl;
+        };
+
+        std::mt19937_64 rng(42);
+        std::vector<int> ints(sort_count);
+        for (auto& value : ints) {
+            value = static_cast<int>(rng());
+        }
+        run_sorts("ints", ints);
+
+        // eight passes instead of four
+        std::vector<std::uint64_t> wide_keys(sort_count);
+        for (auto& value : wide_keys) {
+            value = rng();
+        }
+        run_sorts("uint64_t keys", wide_keys);
+
+        // mixed signs and magnitudes go through the float key transform
+        std::normal_distribution<double> distribution(0.0, 1e6);
+        std::vector<double> doubles(sort_count);
+        for (auto& value : doubles) {
+            value = distribution(rng);
+        }
+        run_sorts("doubles", doubles);
+    }
+    // SIMD Kernels Benchmark
+    {
+        std::vector<std::int32_t> int_values(sort_count);
+        std::vector<double> double_values(sort_count);
+        for (int i = 0; i < sort_count; i++) {
+            int_values[i] = i % 1000;
+            double_values[i] = i % 1000 * 0.5;
+        }
+        ChunkList<std::int32_t, 4096> ints(int_values.begin(), int_values.end());
+        ChunkList<double, 4096> doubles(double_values.begin(), double_values.end());
+
+        auto run_kernels = [](const char* name, const auto& list, auto needle) {
+            using value_type = decltype(needle);
+            std::int64_t checksum = 0;
+            for (int level = 0; level <= static_cast<int>(DetectSimdLevel()); level++) {
+                SimdKernelTable<value_type> kernels = MakeKernelTable<value_type>(static_cast<SimdLevel>(level));
+                auto measure = [&list, &checksum](auto kernel) {
+                    return MeasureMilliseconds([&] {
+                        list.for_each_chunk([&](const value_type* values, std::size_t count) {
+                            checksum += static_cast<std::int64_t>(kernel(values, count));
+                        });
+                    });
+                };
+                std::cout << name << ", " << GetSimdLevelName(static_cast<SimdLevel>(level))
+                    << ": sum " << measure([&](const value_type* v, std::size_t n) { return kernels.sum(v, n); })
+                    << " ms, min/max " << measure([&](const value_type* v, std::size_t n) { return kernels.min(v, n) + kernels.max(v, n); })
+                    << " ms, count " << measure([&](const value_type* v, std::size_t n) { return kernels.count_equal(v, n, needle); })
+                    << " ms, find " << measure([&](const value_type* v, std::size_t n) { return kernels.find_first(v, n, -needle); })
+                    << " ms, any_greater " << measure([&](const value_type* v, std::size_t n) { return kernels.any_greater(v, n, needle * 1000); })
+                    << " ms" << std::endl;
+            }
+            return checksum;
+        };
+
+        if (run_kernels("int32 kernels", ints, std::int32_t(7)) + run_kernels("double kernels", doubles, 7.0) == 42) {
+            std::cout << std::endl;
+        }
+    }
+    // Zone Map Benchmark
+    {
+        // time-ordered timestamps with a little jitter
+        std::mt19937 rng(7);
+        std::vector<std::int64_t> timestamps(sort_count);
+        for (int i = 0; i < sort_count; i++) {
+            timestamps[i] = i * 100LL + static_cast<std::int64_t>(rng() % 500);
+        }
+        ZonedChunkList<std::int64_t, 1024> zoned;
+        zoned.append(timestamps.begin(), timestamps.end());
+
+        std::int64_t low = sort_count * 40LL;
+        std::int64_t high = sort_count * 41LL;
+        std::size_t scan_count = 0;
+        std::size_t zoned_count = 0;
+        zoned.count_in(low, high);
+
+        double scan_time = MeasureMilliseconds([&] {
+            zoned.get_list().for_each_chunk([&](const std::int64_t* values, std::size_t count) {
+                for (std::size_t i = 0; i < count; i++) {
+                    scan_count += values[i] >= low && values[i] <= high;
+                }
+            });
+        });
+        double zoned_time = MeasureMilliseconds([&] { zoned_count = zoned.count_in(low, high); });
+        std::size_t total_chunks = (timestamps.size() + 1023) / 1024;
+        std::size_t scanned_chunks = zoned.count_candidate_chunks(low, high);
+
+        std::cout << "range count over " << sort_count << " timestamps: full scan " << scan_time << " ms, zone maps "
+            << zoned_time << " ms, " << 100.0 * (total_chunks - scanned_chunks) / total_chunks << "% of chunks skipped"
+            << (scan_count == zoned_count ? "" : " (mismatch)") << std::endl;
+    }
+    // Sorted Lookup Benchmark
+    {
+        const int count = 1000000;
+        const int probes = 10000;
+        std::vector<std::int64_t> timestamps(count);
+        SortedChunkList<std::int64_t, 1024> sorted;
+        for (int i = 0; i < count; i++) {
+            timestamps[i] = i * 10LL;
+            sorted.insert(timestamps[i]);
+        }
+        ChunkList<std::int64_t, 1024> list(timestamps.begin(), timestamps.end());
+
+        std::mt19937 rng(11);
+        std::vector<std::int64_t> keys(probes);
+        for (auto& key : keys) {
+            key = rng() % (count * 10LL);
+        }
+        std::int64_t list_checksum = 0;
+        std::int64_t sorted_checksum = 0;
+
+        double list_time = MeasureMilliseconds([&] {
+            for (auto key : keys) {
+                int first = 0;
+                int last = list.get_size();
+                while (first < last) {
+                    int middle = first + (last - first) / 2;
+                    if (list.At(middle) < key) {
+                        first = middle + 1;
+                    }
+                    else {
+                        last = middle;
+                    }
+                }
+                list_checksum += first < list.get_size() ? list.At(first) : 0;
+            }
+        });
+        double sorted_time = MeasureMilliseconds([&] {
+            for (auto key : keys) {
+                auto found = sorted.lower_bound(key);
+                sorted_checksum += found != sorted.end() ? *found : 0;
+            }
+        });
+
+        std::cout << probes << " lower_bounds over " << count << " timestamps: binary search through At "
+            << list_time << " ms, fence keys " << sorted_time << " ms"
+            << (list_checksum == sorted_checksum ? "" : " (mismatch)") << std::endl;
+    }
+    // Bloom Filter Benchmark
+    {
+        const int count = 1000000;
+        const int lookups = 1000;
+        std::mt19937_64 rng(13);
+        std::vector<std::uint64_t> ids(count);
+        for (auto& id : ids) {
+            id = rng();
+        }
+        BloomChunkList<std::uint64_t, 1024> filtered;
+        filtered.append(ids.begin(), ids.end());
+        filtered.contains(0);
+
+        // one lookup in a hundred hits
+        std::vector<std::uint64_t> keys(lookups);
+        for (int i = 0; i < lookups; i++) {
+            keys[i] = i % 100 == 0 ? ids[rng() % count] : rng();
+        }
+        int scan_hits = 0;
+        int filtered_hits = 0;
+
+        double scan_time = MeasureMilliseconds([&] {
+            for (auto key : keys) {
+                bool found = false;
+                filtered.get_list().for_each_chunk([&](const std::uint64_t* values, std::size_t size) {
+                    found = found || std::find(values, values + size, key) != values + size;
+                });
+                scan_hits += found;
+            }
+        });
+        double filtered_time = MeasureMilliseconds([&] {
+            for (auto key : keys) {
+                filtered_hits += filtered.contains(key);
+            }
+        });
+
+        std::cout << lookups << " lookups over " << count << " ids at a 1% hit ratio: full scan " << scan_time
+            << " ms, bloom filters " << filtered_time << " ms"
+            << (scan_hits == filtered_hits ? "" : " (mismatch)") << std::endl;
+    }
+    // Hash Map Insert Latency Benchmark
+    {
+        std::mt19937_64 rng(17);
+        std::vector<std::uint64_t> keys(sort_count);
+        for (auto& key : keys) {
+            key = rng();
+        }
+
+        // slowest single insert, a rehash of std::unordered_map shows up here
+        auto max_insert = [&keys](auto& map) {
+            double slowest = 0;
+            for (auto key : keys) {
+                slowest = std::max(slowest, MeasureMilliseconds([&] {
+                    map[key] = 1;
+                }));
+            }
+            return slowest;
+        };
+        double chunk_slowest = 0;
+        double chunk_time = MeasureMilliseconds([&] {
+            ChunkHashMap<std::uint64_t, int, 8> map;
+            chunk_slowest = max_insert(map);
+        });
+        double std_slowest = 0;
+        double std_time = MeasureMilliseconds([&] {
+            std::unordered_map<std::uint64_t, int> map;
+            std_slowest = max_insert(map);
+        });
+
+        std::cout << sort_count << " hash map inserts: std::unordered_map " << std_time << " ms (slowest "
+            << std_slowest << " ms), linear hashing on chunks " << chunk_time << " ms (slowest "
+            << chunk_slowest << " ms)" << std::endl;
+    }
+    // Concurrent Append Benchmark
+    {
+        const int count = 1000000;
+        for (int producers : { 1, 2, 4, 8, 16 }) {
+            auto run_producers = [producers](auto append) {
+                return MeasureMilliseconds([&] {
+                    std::vector<std::thread> threads;
+                    for (int p = 0; p < producers; p++) {
+                        threads.emplace_back([&append, p, producers] {
+                            for (int i = p; i < count; i += producers) {
+                                append(i);
+                            }
+                        });
+                    }
+                    for (auto& thread : threads) {
+                        thread.join();
+                    }
+                });
+            };
+            ChunkList<int, 4096> locked;
+            std::mutex mutex;
+            double locked_time = run_producers([&](int value) {
+                std::lock_guard<std::mutex> lock(mutex);
+                locked.push_back(value);
+            });
+            ConcurrentChunkList<int, 4096> concurrent;
+            double concurrent_time = run_producers([&](int value) {
+                concurrent.push_back(value);
+            });
+
+            std::cout << count << " appends from " << producers << " producers: mutex around push_back "
+                << locked_time << " ms, fetch_add slot reservation " << concurrent_time << " ms"
+                << (locked.get_size() == static_cast<int>(concurrent.get_size()) ? "" : " (mismatch)") << std::endl;
+        }
+    }
+    // MPMC Queue Benchmark
+    {
+        const int operations = 2000000;
+        for (int thread_count : { 1, 2, 4, 8, 16, 32 }) {
+            // every thread pushes one element and pops one, so the queue never runs dry for long
+            auto run_threads = [thread_count](auto push, auto pop) {
+                return MeasureMilliseconds([&] {
+                    std::vector<std::thread> threads;
+                    for (int t = 0; t < thread_count; t++) {
+                        threads.emplace_back([&push, &pop, thread_count] {
+                            for (int i = 0; i < operations / thread_count; i++) {
+                                push(i);
+                                while (!pop()) {
+                                    std::this_thread::yield();
+                                }
+                            }
+                        });
+                    }
+                    for (auto& thread : threads) {
+                        thread.join();
+                    }
+                });
+            };
+            std::deque<int> locked;
+            std::mutex mutex;
+            double locked_time = run_threads([&](int value) {
+                std::lock_guard<std::mutex> lock(mutex);
+                locked.push_back(value);
+            }, [&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (locked.empty()) {
+                    return false;
+                }
+                locked.pop_front();
+                return true;
+            });
+            ChunkQueue<int, 256> queue;
+            double queue_time = run_threads([&](int value) {
+                queue.push(value);
+            }, [&] {
+                int value;
+                return queue.try_pop(value);
+            });
+
+            std::cout << operations << " push/pop pairs on " << thread_count << " threads: mutex and std::deque "
+                << locked_time << " ms, chunk segment queue " << queue_time << " ms" << std::endl;
+        }
+    }
+    // SPSC Queue Benchmark
+    {
+        auto run_pipeline = [sort_count](auto consume) {
+            SpscChunkQueue<int, 4096> queue;
+            long long checksum = 0;
+            double time = MeasureMilliseconds([&] {
+                std::thread producer([&queue, sort_count] {
+                    for (int i = 0; i < sort_count; i++) {
+                        queue.push(i);
+                    }
+                });
+                long long received = 0;
+                while (received < sort_count) {
+                    received += consume(queue, checksum);
+                }
+                producer.join();
+            });
+            return std::make_pair(time, checksum);
+        };
+        auto single = run_pipeline([](SpscChunkQueue<int, 4096>& queue, long long& checksum) {
+            int value;
+            if (!queue.try_pop(value)) {
+                return 0;
+            }
+            checksum += value;
+            return 1;
+        });
+        auto spans = run_pipeline([](SpscChunkQueue<int, 4096>& queue, long long& checksum) {
+            return static_cast<int>(queue.consume_span([&checksum](const int* values, std::size_t count) {
+                for (std::size_t i = 0; i < count; i++) {
+                    checksum += values[i];
+                }
+            }));
+        });
+
+        std::cout << sort_count << " items through an SPSC chunk queue: try_pop " << single.first << " ms ("
+            << sort_count / single.first / 1000 << " M items/s), consume_span " << spans.first << " ms ("
+            << sort_count / spans.first / 1000 << " M items/s)"
+            << (single.second == spans.second ? "" : " (mismatch)") << std::endl;
+    }
+    // Striped Locking Benchmark
+    {
+        const int count = 1000000;
+        const int operations = 2000000;
+        std::vector<long long> zeros(count, 0);
+        for (int thread_count : { 1, 2, 4, 8 }) {
+            // 90% updates, 9.9% loads and 0.1% appends at random positions
+            auto run_mixed = [thread_count](auto push_back, auto load, auto update) {
+                return MeasureMilliseconds([&] {
+                    std::vector<std::thread> threads;
+                    for (int t = 0; t < thread_count; t++) {
+                        threads.emplace_back([&push_back, &load, &update, t, thread_count] {
+                            std::mt19937 rng(t);
+                            long long sink = 0;
+                            for (int i = 0; i < operations / thread_count; i++) {
+                                int kind = rng() % 1000;
+                                int pos = rng() % count;
+                                if (kind == 0) {
+                                    push_back(1);
+                                }
+                                else if (kind < 100) {
+                                    sink += load(pos);
+                                }
+                                else {
+                                    update(pos);
+                                }
+                            }
+                            volatile long long keep = sink;
+                            (void)keep;
+                        });
+                    }
+                    for (auto& thread : threads) {
+                        thread.join();
+                    }
+                });
+            };
+            auto run_striped = [&run_mixed, &zeros](auto& list) {
+                list.append(zeros.begin(), zeros.end());
+                return run_mixed([&list](long long value) { list.push_back(value); },
+                    [&list](int pos) { return list.load(pos); },
+                    [&list](int pos) { list.update(pos, [](long long& value) { value++; }); });
+            };
+            // a plain ChunkList also walks the chunk chain on every access, the stripes index their chunks
+            ChunkList<long long, 1024> locked;
+            locked.append(zeros.begin(), zeros.end());
+            std::mutex mutex;
+            double locked_time = run_mixed([&](long long value) {
+                std::lock_guard<std::mutex> lock(mutex);
+                locked.push_back(value);
+            }, [&](int pos) {
+                std::lock_guard<std::mutex> lock(mutex);
+                return locked[pos];
+            }, [&](int pos) {
+                std::lock_guard<std::mutex> lock(mutex);
+                locked[pos]++;
+            });
+            StripedChunkList<long long, 1024, 1> single;
+            double single_time = run_striped(single);
+            StripedChunkList<long long, 1024, 64> striped;
+            double striped_time = run_striped(striped);
+
+            std::cout << operations << " mixed operations on " << thread_count << " threads: mutex around ChunkList "
+                << locked_time << " ms, single stripe " << single_time << " ms, 64 stripes " << striped_time
+                << " ms" << std::endl;
+        }
+    }
+    // Block Cache Benchmark
+    {
+        const int rounds = 2000;
+        const int blocks = 64;
+        const std::size_t block_size = 4096;
+        for (int thread_count : { 1, 4, 16, 64 }) {
+            // every thread allocates a batch of chunk-sized blocks and frees them again
+            auto run_threads = [thread_count](auto allocate, auto deallocate) {
+                return MeasureMilliseconds([&] {
+                    std::vector<std::thread> threads;
+                    for (int t = 0; t < thread_count; t++) {
+                        threads.emplace_back([&allocate, &deallocate] {
+                            std::vector<void*> batch(blocks);
+                            for (int r = 0; r < rounds; r++) {
+                                for (auto& block : batch) {
+                                    block = allocate(block_size);
+                                    static_cast<char*>(block)[0] = 1;
+                                }
+                                for (auto block : batch) {
+                                    deallocate(block);
+                                }
+                            }
+                        });
+                    }
+                    for (auto& thread : threads) {
+                        thread.join();
+                    }
+                });
+            };
+            double malloc_time = run_threads([](std::size_t bytes) {
+                return std::malloc(bytes);
+            }, [](void* block) {
+                std::free(block);
+            });
+            double cache_time = run_threads([](std::size_t bytes) {
+                return BlockCache::Instance().allocate(bytes);
+            }, [](void* block) {
+                BlockCache::Instance().deallocate(block);
+            });
+
+            std::cout << thread_count * rounds * blocks << " block allocations on " << thread_count
+                << " threads: malloc " << malloc_time << " ms, thread-local magazines " << cache_time << " ms" << std::endl;
+        }
+    }
+    // Chunk List Builder Benchmark
+    {
+        const int count = 400000; //push_back walks to the last chunk, so the shared list stays small
+        for (int thread_count : { 1, 4, 16 }) {
+            // odd shares, so most builders start behind a partly filled chunk
+            const int share = count / thread_count + 1;
+            double locked_time = MeasureMilliseconds([&] {
+                ChunkList<int, 1024> list;
+                std::mutex mutex;
+                std::vector<std::thread> threads;
+                for (int t = 0; t < thread_count; t++) {
+                    threads.emplace_back([&list, &mutex, share] {
+                        for (int i = 0; i < share; i++) {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            list.push_back(i);
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+            });
+            double merge_time = 0;
+            ChunkList<int, 1024> merged;
+            double builder_time = MeasureMilliseconds([&] {
+                std::vector<ChunkList<int, 1024>::Builder> builders(thread_count);
+                std::vector<std::thread> threads;
+                for (int t = 0; t < thread_count; t++) {
+                    threads.emplace_back([&builders, t, share] {
+                        for (int i = 0; i < share; i++) {
+                            builders[t].push_back(i);
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                merge_time = MeasureMilliseconds([&] {
+                    merged = ChunkList<int, 1024>::merge(builders);
+                });
+            });
+
+            std::cout << share * thread_count << " appends on " << thread_count << " threads: locked push_back "
+                << locked_time << " ms, builders " << builder_time << " ms (merge " << merge_time << " ms)" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Hash map that grows by linear hashing: every insert that pushes the load over the limit splits
+    // exactly one bucket, so there is never a full rehash and the worst-case insert only touches one
+    // bucket. A bucket is a chain of chunks of N entries; buckets are addressed in O(1) through a
+    // directory of fixed-size segments, so growing the directory never copies buckets either.
+    template <typename Key, typename Value, int N = 8, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class ChunkHashMap {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using size_type = std::size_t;
+
+    private:
+        static constexpr size_type SegmentSize = 1024;
+        static constexpr size_type InitialBuckets = 4;
+
+        size_type size = 0;
+        size_type level_buckets = InitialBuckets; //bucket count at the start of the current round
+        size_type split = 0; //next bucket to split, buckets below it are already split in this round
+        std::vector<std::unique_ptr<Chunk<value_type>*[]>> segments;
+        Hash hasher;
+        KeyEqual key_equal;
+
+    public:
+        explicit ChunkHashMap(const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            : hasher(hash), key_equal(equal) {
+            EnsureSegments(InitialBuckets);
+        }
+
+        ChunkHashMap(const ChunkHashMap& other) = delete;
+
+        ChunkHashMap& operator=(const ChunkHashMap& other) = delete;
+
+        ~ChunkHashMap() {
+            ReleaseBuckets();
+        }
+
+        size_type get_size() const noexcept {
+            return size;
+        }
+
+        bool empty() const noexcept {
+            return size == 0;
+        }
+
+        size_type bucket_count() const noexcept {
+            return level_buckets + split;
+        }
+
+        // returns false and leaves the map untouched when the key is already there
+        bool insert(const Key& key, const Value& value) {
+            size_type hash = hasher(key);
+            if (FindInBucket(GetBucketFor(hash), key) != nullptr) {
+                return false;
+            }
+            Emplace(hash, key, value);
+            return true;
+        }
+
+        Value& operator[](const Key& key) {
+            size_type hash = hasher(key);
+            value_type* found = FindInBucket(GetBucketFor(hash), key);
+            if (found != nullptr) {
+                return found->second;
+            }
+            return Emplace(hash, key, Value())->second;
+        }
+
+        Value* find(const Key& key) {
+            value_type* found = FindInBucket(GetBucketFor(hasher(key)), key);
+            return found == nullptr ? nullptr : &found->second;
+        }
+
+        const Value* find(const Key& key) const {
+            const value_type* found = FindInBucket(GetBucketFor(hasher(key)), key);
+            return found == nullptr ? nullptr : &found->second;
+        }
+
+        bool contains(const Key& key) const {
+            return find(key) != nullptr;
+        }
+
+        Value& At(const Key& key) {
+            Value* found = find(key);
+            if (found == nullptr) {
+                throw std::out_of_range("Key is not in the map!");
+            }
+            return *found;
+        }
+
+        // the hole is filled with the last entry of the bucket, an emptied overflow chunk is released
+        bool erase(const Key& key) {
+            Chunk<value_type>*& bucket = GetBucketFor(hasher(key));
+            for (Chunk<value_type>* temp_pointer = bucket; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                for (int i = 0; i < temp_pointer->current_size; i++) {
+                    if (key_equal(temp_pointer->list[i].first, key)) {
+                        Chunk<value_type>* last_chunk = temp_pointer;
+                        while (last_chunk->next != nullptr) {
+                            last_chunk = last_chunk->next;
+                        }
+                        value_type& last = last_chunk->list[last_chunk->current_size - 1];
+                        if (&last != &temp_pointer->list[i]) {
+                            temp_pointer->list[i] = std::move(last);
+                        }
+                        last.~value_type();
+                        last_chunk->current_size--;
+                        if (last_chunk->current_size == 0 && last_chunk != bucket) {
+                            last_chunk->prev->next = nullptr;
+                            ReleaseChunk(last_chunk);
+                        }
+                        size--;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // calls f(key, value) for every entry, in no particular order
+        template <typename Function>
+        void for_each(Function f) const {
+            for (size_type i = 0; i < bucket_count(); i++) {
+                for (Chunk<value_type>* temp_pointer = GetBucket(i); temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                    for (int j = 0; j < temp_pointer->current_size; j++) {
+                        f(static_cast<const value_type&>(temp_pointer->list[j]).first,
+                          static_cast<const value_type&>(temp_pointer->list[j]).second);
+                    }
+                }
+            }
+        }
+
+        void clear() {
+            ReleaseBuckets();
+            segments.clear();
+            level_buckets = InitialBuckets;
+            split = 0;
+            size = 0;
+            EnsureSegments(InitialBuckets);
+        }
+
+    private:
+        size_type GetBucketIndex(size_type hash) const noexcept {
+            size_type index = hash & (level_buckets - 1);
+            return index < split ? hash & (2 * level_buckets - 1) : index;
+        }
+
+        Chunk<value_type>*& GetBucketFor(size_type hash) const {
+            return GetBucket(GetBucketIndex(hash));
+        }
+
+        Chunk<value_type>*& GetBucket(size_type index) const {
+            return segments[index / SegmentSize][index % SegmentSize];
+        }
+
+        value_type* FindInBucket(Chunk<value_type>* bucket, const Key& key) const {
+            for (Chunk<value_type>* temp_pointer = bucket; temp_pointer != nullptr; temp_pointer = temp_pointer->next) {
+                for (int i = 0; i < temp_pointer->current_size; i++) {
+                    if (key_equal(temp_pointer->list[i].first, key)) {
+                        return temp_pointer->list + i;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        value_type* Emplace(size_type hash, const Key& key, const Value& value) {
+            value_type* slot = AppendToBucket(GetBucketFor(hash), value_type(key, value));
+            size++;
+            if (size > bucket_count() * N * 3 / 4) {
+                SplitBucket();
+                slot = FindInBucket(GetBucketFor(hash), key);
+            }
+            return slot;
+        }
+
+        value_type* AppendToBucket(Chunk<value_type>*& bucket, value_type&& entry) {
+            if (bucket == nullptr) {
+                bucket = new Chunk<value_type>(N);
+            }
+            Chunk<value_type>* temp_pointer = bucket;
+            while (temp_pointer->current_size == N) {
+                if (temp_pointer->next == nullptr) {
+                    temp_pointer->next = new Chunk<value_type>(N);
+                    temp_pointer->next->prev = temp_pointer;
+                }
+                temp_pointer = temp_pointer->next;
+            }
+            value_type* slot = temp_pointer->list + temp_pointer->current_size;
+            ::new (static_cast<void*>(slot)) value_type(std::move(entry));
+            temp_pointer->current_size++;
+            return slot;
+        }
+
+        // moves the entries of the bucket at the split pointer that belong to its new sibling
+        void SplitBucket() {
+            size_type new_index = level_buckets + split;
+            EnsureSegments(new_index + 1);
+            Chunk<value_type>* old_chain = GetBucket(split);
+            GetBucket(split) = nullptr;
+            split++;
+            if (split == level_buckets) {
+                level_buckets *= 2;
+                split = 0;
+            }
+            while (old_chain != nullptr) {
+                for (int i = 0; i < old_chain->current_size; i++) {
+                    AppendToBucket(GetBucketFor(hasher(old_chain->list[i].first)), std::move(old_chain->list[i]));
+                }
+                Chunk<value_type>* next = old_chain->next;
+                ReleaseChunk(old_chain);
+                old_chain = next;
+            }
+        }
+
+        void EnsureSegments(size_type buckets) {
+            while (segments.size() * SegmentSize < buckets) {
+                segments.emplace_back(new Chunk<value_type>*[SegmentSize]());
+            }
+        }
+
+        void ReleaseBuckets() noexcept {
+            for (size_type i = 0; i < bucket_count(); i++) {
+                Chunk<value_type>*& bucket = GetBucket(i);
+                while (bucket != nullptr) {
+                    Chunk<value_type>* next = bucket->next;
+                    ReleaseChunk(bucket);
+                    bucket = next;
+                }
+            }
+        }
+
+        void ReleaseChunk(Chunk<value_type>* chunk) noexcept {
+            for (int i = 0; i < chunk->current_size; i++) {
+                chunk->list[i].~value_type();
+            }
+            chunk->allocator.deallocate(chunk->list, chunk->size);
+            delete chunk;
+        }
+    };
+}
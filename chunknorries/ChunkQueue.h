@@ -0,0 +1,259 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Unbounded lock-free multi-producer multi-consumer queue over linked chunk segments.
+    // Producers and consumers claim positions with a CAS on the tail and head indices; the position
+    // after the last slot of a segment is reserved for the thread that links or enters the next one.
+    // Every slot records whether it was written, read, and whether the segment is being retired, so
+    // the last reader of a segment retires it without any other reclamation scheme. Retired segments
+    // are kept in a few spare slots and reused by producers before new ones are allocated.
+    // T has to be nothrow movable, so a claimed slot is always filled.
+    template <typename T, int N = 64, typename Allocator = Allocator<T>>
+    class ChunkQueue {
+        static_assert(N >= 2, "segments have to hold at least two elements");
+        static_assert(std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+                      "ChunkQueue elements have to be nothrow movable");
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+
+    private:
+        static constexpr size_type Shift = 1; //the lowest index bit marks a head that knows a next segment exists
+        static constexpr size_type HasNext = 1;
+        static constexpr size_type Lap = N + 1;
+        static constexpr int SpareCount = 4;
+
+        static constexpr unsigned SlotWritten = 1;
+        static constexpr unsigned SlotRead = 2;
+        static constexpr unsigned SlotRetiring = 4;
+
+        struct Segment {
+            Chunk<value_type> chunk;
+            std::atomic<unsigned> states[N];
+            std::atomic<Segment*> next{ nullptr };
+
+            explicit Segment(const Allocator& alloc) : chunk(N, alloc) {
+                Reset();
+            }
+
+            void Reset() noexcept {
+                for (auto& state : states) {
+                    state.store(0, std::memory_order_relaxed);
+                }
+                next.store(nullptr, std::memory_order_relaxed);
+            }
+
+            Segment* WaitNext() const noexcept {
+                Segment* next_segment;
+                while ((next_segment = next.load(std::memory_order_acquire)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                return next_segment;
+            }
+        };
+
+        struct alignas(64) Position {
+            std::atomic<size_type> index{ 0 };
+            std::atomic<Segment*> segment{ nullptr };
+        };
+
+        Position head;
+        Position tail;
+        std::atomic<Segment*> spares[SpareCount];
+        Allocator allocator;
+
+    public:
+        explicit ChunkQueue(const Allocator& alloc = Allocator()) : allocator(alloc) {
+            for (auto& spare : spares) {
+                spare.store(nullptr, std::memory_order_relaxed);
+            }
+            Segment* first = new Segment(allocator);
+            head.segment.store(first, std::memory_order_relaxed);
+            tail.segment.store(first, std::memory_order_relaxed);
+        }
+
+        ChunkQueue(const ChunkQueue& other) = delete;
+
+        ChunkQueue& operator=(const ChunkQueue& other) = delete;
+
+        ~ChunkQueue() {
+            size_type head_index = head.index.load(std::memory_order_relaxed) & ~HasNext;
+            size_type tail_index = tail.index.load(std::memory_order_relaxed) & ~HasNext;
+            Segment* segment = head.segment.load(std::memory_order_relaxed);
+            for (; head_index != tail_index; head_index += 1 << Shift) {
+                size_type offset = (head_index >> Shift) % Lap;
+                if (offset < N) {
+                    segment->chunk.list[offset].~value_type();
+                }
+                else {
+                    Segment* next = segment->next.load(std::memory_order_relaxed);
+                    ReleaseSegment(segment);
+                    segment = next;
+                }
+            }
+            ReleaseSegment(segment);
+            for (auto& spare : spares) {
+                Segment* cached = spare.load(std::memory_order_relaxed);
+                if (cached != nullptr) {
+                    ReleaseSegment(cached);
+                }
+            }
+        }
+
+        // a snapshot that may already be stale when it returns
+        bool empty() const noexcept {
+            size_type head_index = head.index.load(std::memory_order_seq_cst);
+            size_type tail_index = tail.index.load(std::memory_order_seq_cst);
+            return head_index >> Shift == tail_index >> Shift;
+        }
+
+        void push(const T& value) {
+            emplace(value);
+        }
+
+        void push(T&& value) {
+            emplace(std::move(value));
+        }
+
+        // the element is built before a slot is claimed, so a throwing constructor leaves the queue untouched
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            value_type value(std::forward<Args>(args)...);
+            Segment* next_segment = nullptr;
+            size_type tail_index = tail.index.load(std::memory_order_acquire);
+            Segment* segment = tail.segment.load(std::memory_order_acquire);
+            while (true) {
+                size_type offset = (tail_index >> Shift) % Lap;
+                if (offset == N) {
+                    // another producer is linking the next segment
+                    std::this_thread::yield();
+                    tail_index = tail.index.load(std::memory_order_acquire);
+                    segment = tail.segment.load(std::memory_order_acquire);
+                    continue;
+                }
+                if (offset + 1 == N && next_segment == nullptr) {
+                    next_segment = AcquireSegment();
+                }
+
+                size_type new_tail = tail_index + (1 << Shift);
+                if (tail.index.compare_exchange_weak(tail_index, new_tail, std::memory_order_seq_cst, std::memory_order_acquire)) {
+                    if (offset + 1 == N) {
+                        tail.segment.store(next_segment, std::memory_order_release);
+                        tail.index.store(new_tail + (1 << Shift), std::memory_order_release);
+                        segment->next.store(next_segment, std::memory_order_release);
+                        next_segment = nullptr;
+                    }
+                    ::new (static_cast<void*>(segment->chunk.list + offset)) value_type(std::move(value));
+                    segment->states[offset].fetch_or(SlotWritten, std::memory_order_release);
+                    break;
+                }
+                segment = tail.segment.load(std::memory_order_acquire);
+            }
+            if (next_segment != nullptr) {
+                RecycleSegment(next_segment);
+            }
+        }
+
+        // moves the front element into value, returns false when the queue was empty
+        bool try_pop(T& value) {
+            size_type head_index = head.index.load(std::memory_order_acquire);
+            Segment* segment = head.segment.load(std::memory_order_acquire);
+            while (true) {
+                size_type offset = (head_index >> Shift) % Lap;
+                if (offset == N) {
+                    // another consumer is entering the next segment
+                    std::this_thread::yield();
+                    head_index = head.index.load(std::memory_order_acquire);
+                    segment = head.segment.load(std::memory_order_acquire);
+                    continue;
+                }
+
+                size_type new_head = head_index + (1 << Shift);
+                if ((new_head & HasNext) == 0) {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    size_type tail_index = tail.index.load(std::memory_order_relaxed);
+                    if (head_index >> Shift == tail_index >> Shift) {
+                        return false;
+                    }
+                    if ((head_index >> Shift) / Lap != (tail_index >> Shift) / Lap) {
+                        new_head |= HasNext;
+                    }
+                }
+
+                if (head.index.compare_exchange_weak(head_index, new_head, std::memory_order_seq_cst, std::memory_order_acquire)) {
+                    if (offset + 1 == N) {
+                        Segment* next = segment->WaitNext();
+                        size_type next_index = (new_head & ~HasNext) + (1 << Shift);
+                        if (next->next.load(std::memory_order_relaxed) != nullptr) {
+                            next_index |= HasNext;
+                        }
+                        head.segment.store(next, std::memory_order_release);
+                        head.index.store(next_index, std::memory_order_release);
+                    }
+
+                    while ((segment->states[offset].load(std::memory_order_acquire) & SlotWritten) == 0) {
+                        std::this_thread::yield();
+                    }
+                    value = std::move(segment->chunk.list[offset]);
+                    segment->chunk.list[offset].~value_type();
+
+                    if (offset + 1 == N) {
+                        Retire(segment, 0);
+                    }
+                    else if (segment->states[offset].fetch_or(SlotRead, std::memory_order_acq_rel) & SlotRetiring) {
+                        Retire(segment, offset + 1);
+                    }
+                    return true;
+                }
+                segment = head.segment.load(std::memory_order_acquire);
+            }
+        }
+
+    private:
+        // recycles the segment once every slot from first on is read; a slot whose reader is still busy
+        // is marked, and that reader continues the retirement when it is done
+        void Retire(Segment* segment, int first) {
+            for (int i = first; i < N - 1; i++) {
+                std::atomic<unsigned>& state = segment->states[i];
+                if ((state.load(std::memory_order_acquire) & SlotRead) == 0 &&
+                    (state.fetch_or(SlotRetiring, std::memory_order_acq_rel) & SlotRead) == 0) {
+                    return;
+                }
+            }
+            RecycleSegment(segment);
+        }
+
+        Segment* AcquireSegment() {
+            for (auto& spare : spares) {
+                Segment* cached = spare.exchange(nullptr, std::memory_order_acquire);
+                if (cached != nullptr) {
+                    return cached;
+                }
+            }
+            return new Segment(allocator);
+        }
+
+        void RecycleSegment(Segment* segment) noexcept {
+            segment->Reset();
+            for (auto& spare : spares) {
+                Segment* empty_spare = nullptr;
+                if (spare.compare_exchange_strong(empty_spare, segment, std::memory_order_release, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+            ReleaseSegment(segment);
+        }
+
+        // the elements are already destroyed by their readers
+        void ReleaseSegment(Segment* segment) noexcept {
+            segment->chunk.allocator.deallocate(segment->chunk.list, segment->chunk.size);
+            delete segment;
+        }
+    };
+}
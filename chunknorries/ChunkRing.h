@@ -0,0 +1,206 @@
+#pragma once
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Bounded buffer that keeps at least the last `capacity` elements.
+    // All chunks are allocated up front; once they are all used the oldest one
+    // is emptied and reused as the new tail, so appends never allocate.
+    template <typename T, int N, typename Allocator = Allocator<T>>
+    class ChunkRing : public IChunkList<T> {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using iterator = ChunkList_iterator<value_type>;
+        using const_iterator = ChunkList_const_iterator<value_type>;
+
+    private:
+        int size = 0;
+        int head = 0; //directory index of the oldest chunk
+        int tail = 0; //directory index of the chunk being filled
+        std::vector<Chunk<value_type>*> chunks;
+
+    public:
+        explicit ChunkRing(size_type capacity, const Allocator& alloc = Allocator())
+            : chunks((capacity + N - 1) / N + 1, nullptr)
+        {
+            try {
+                for (auto& chunk : chunks) {
+                    chunk = new Chunk<value_type>(N, alloc);
+                }
+            }
+            catch (...) {
+                ReleaseChunks();
+                throw;
+            }
+        }
+
+        ChunkRing(const ChunkRing& other) = delete;
+
+        ChunkRing& operator=(const ChunkRing& other) = delete;
+
+        ~ChunkRing() {
+            clear();
+            ReleaseChunks();
+        }
+
+        size_t GetSize() const noexcept override {
+            return size;
+        }
+
+        int get_size() const noexcept {
+            return size;
+        }
+
+        bool empty() const noexcept {
+            return size == 0;
+        }
+
+        // number of elements that are guaranteed to be retained
+        size_type capacity() const noexcept {
+            return (chunks.size() - 1) * N;
+        }
+
+        reference At(size_type pos) override {
+            if (pos >= static_cast<size_type>(size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            return chunks[(head + pos / N) % chunks.size()]->list[pos % N];
+        }
+
+        const_reference At(size_type pos) const {
+            if (pos >= static_cast<size_type>(size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            return chunks[(head + pos / N) % chunks.size()]->list[pos % N];
+        }
+
+        reference operator[](difference_type pos) override {
+            return chunks[(head + pos / N) % chunks.size()]->list[pos % N];
+        }
+
+        const_reference operator[](difference_type pos) const {
+            return chunks[(head + pos / N) % chunks.size()]->list[pos % N];
+        }
+
+        reference front() {
+            if (size == 0) {
+                throw std::runtime_error("ChunkRing is empty!");
+            }
+            return chunks[head]->list[0];
+        }
+
+        const_reference front() const {
+            if (size == 0) {
+                throw std::runtime_error("ChunkRing is empty!");
+            }
+            return chunks[head]->list[0];
+        }
+
+        reference back() {
+            if (size == 0) {
+                throw std::runtime_error("ChunkRing is empty!");
+            }
+            return chunks[tail]->list[chunks[tail]->current_size - 1];
+        }
+
+        const_reference back() const {
+            if (size == 0) {
+                throw std::runtime_error("ChunkRing is empty!");
+            }
+            return chunks[tail]->list[chunks[tail]->current_size - 1];
+        }
+
+        iterator begin() noexcept {
+            if (size == 0) {
+                return end();
+            }
+            return ChunkList_iterator<value_type>(&At(0), 0, this);
+        }
+
+        const_iterator begin() const noexcept {
+            if (size == 0) {
+                return end();
+            }
+            return ChunkList_const_iterator<value_type>(&At(0), 0, this);
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        iterator end() noexcept {
+            return ChunkList_iterator<value_type>();
+        }
+
+        const_iterator end() const noexcept {
+            return ChunkList_const_iterator<value_type>();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            Chunk<value_type>* temp_pointer = chunks[tail];
+            if (temp_pointer->current_size == N) {
+                int next_tail = (tail + 1) % chunks.size();
+                if (next_tail == head) {
+                    pop_front_chunk();
+                }
+                tail = next_tail;
+                temp_pointer = chunks[tail];
+            }
+            pointer slot = temp_pointer->list + temp_pointer->current_size;
+            ::new (static_cast<void*>(slot)) value_type(std::forward<Args>(args)...);
+            temp_pointer->current_size++;
+            size++;
+            return *slot;
+        }
+
+        // drops the oldest chunk of elements at once
+        void pop_front_chunk() {
+            Chunk<value_type>* temp_pointer = chunks[head];
+            for (int i = 0; i < temp_pointer->current_size; i++) {
+                temp_pointer->list[i].~value_type();
+            }
+            size -= temp_pointer->current_size;
+            temp_pointer->current_size = 0;
+            if (head != tail) {
+                head = (head + 1) % chunks.size();
+            }
+        }
+
+        void clear() noexcept {
+            while (size > 0) {
+                pop_front_chunk();
+            }
+            head = 0;
+            tail = 0;
+        }
+
+    private:
+        void ReleaseChunks() noexcept {
+            for (auto& chunk : chunks) {
+                if (chunk != nullptr) {
+                    chunk->allocator.deallocate(chunk->list, chunk->size);
+                    delete chunk;
+                    chunk = nullptr;
+                }
+            }
+        }
+    };
+}
@@ -1,6 +1,28 @@
-#include "ChunkList.h"
+#include "Chunk.h"
+#include "BloomChunkList.h"
+#include "AggregatedChunkList.h"
+#include "BlockCache.h"
+#include "ChunkHashMap.h"
+#include "ChunkQueue.h"
+#include "ChunkRing.h"
+#include "ConcurrentChunkArray.h"
+#include "ConcurrentChunkList.h"
+#include "SnapshotChunkList.h"
+#include "SortedChunkList.h"
+#include "StripedChunkList.h"
+#include "SpscChunkQueue.h"
+#include "ZonedChunkList.h"
+#include <atomic>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace chucknorries;
 
@@ -65,6 +87,34 @@ int main() {
 
         assert(first_list.get_size() == second_list.get_size());
     }
+    // Large Copy Test
+    {
+        std::vector<int> values(400000);
+        for (int i = 0; i < 400000; i++) {
+            values[i] = i;
+        }
+        ChunkList<int, 16> list(values.begin(), values.end());
+        list.push_front(-1);
+
+        ChunkList<int, 16> copy(list);
+        ChunkList<int, 16> assigned;
+        assigned.push_back(7);
+        assigned = copy;
+        ChunkList<int, 16> moved(std::move(copy), CachingAllocator<int>());
+
+        assert(copy.empty());
+        assert(moved.get_allocator().uses_block_cache());
+        assert(assigned.get_size() == 400001 && moved.get_size() == 400001);
+        int expected = -1;
+        moved.for_each_chunk([&expected](const int* values, std::size_t count) {
+            for (std::size_t i = 0; i < count; i++) {
+                assert(values[i] == expected);
+                expected++;
+            }
+        });
+        assert(expected == 400000);
+        assert(assigned.front() == -1 && assigned.back() == 399999 && assigned[200000] == 199999);
+    }
     // Assign Test
     {
         Allocator<int> allocator;
@@ -185,7 +235,1579 @@ int main() {
         list.pop_back();
         assert(list[list.get_size() - 1] == 8);
     }
+    // Range Constructor Test
+    {
+        std::vector<int> values = { 0, 1, 2, 3, 4, 5, 6 };
+        ChunkList<int, 3> list(values.begin(), values.end());
+
+        assert(list.get_size() == 7);
+
+        for (int i = 0; i < 7; i++) {
+            assert(list[i] == i);
+        }
+    }
+    // Append Test
+    {
+        ChunkList<int, 3> list;
+        int values[] = { 2, 3, 4, 5, 6 };
+
+        list.push_back(0);
+        list.push_back(1);
+        list.append(values, values + 5);
+
+        std::istringstream stream("7 8 9");
+        list.append(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+
+        assert(list.get_size() == 10);
+
+        for (int i = 0; i < 10; i++) {
+            assert(list[i] == i);
+        }
+    }
+    // Throwing Append Test
+    {
+        // constructors throw once builds_left runs out, live counts the elements that exist
+        struct Thrower {
+            static int& builds_left() { static int value = -1; return value; }
+            static int& live() { static int value = 0; return value; }
+
+            int value;
+
+            Thrower(int value) : value(value) { Build(); }
+
+            Thrower(const Thrower& other) : value(other.value) { Build(); }
+
+            ~Thrower() { live()--; }
+
+            static void Build() {
+                if (builds_left() == 0) {
+                    throw std::runtime_error("build failed");
+                }
+                builds_left()--;
+                live()++;
+            }
+        };
+
+        std::vector<Thrower> values;
+        for (int i = 0; i < 10; i++) {
+            values.emplace_back(i);
+        }
+        std::istringstream stream("0 1 2 3 4 5 6 7 8 9");
+        for (int single_pass = 0; single_pass < 2; single_pass++) {
+            ChunkList<Thrower, 2> list;
+            list.push_back(Thrower(-1));
+            Thrower::builds_left() = 6;
+            bool thrown = false;
+            try {
+                if (single_pass == 0) {
+                    list.append(values.begin(), values.end());
+                }
+                else {
+                    list.append(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+                }
+            }
+            catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            Thrower::builds_left() = -1;
+            assert(thrown);
+            assert(list.get_size() == 1 && Thrower::live() == 11);
+
+            list.push_back(99);
+            assert(list.get_size() == 2 && list[0].value == -1 && list[1].value == 99 && list.back().value == 99);
+        }
+        assert(Thrower::live() == 10);
+    }
+    // Range Insert Test
+    {
+        ChunkList<int, 3> list;
+        std::vector<int> values = { 2, 3, 4, 5 };
+
+        for (int i = 0; i < 8; i++) {
+            if (i < 2 || i > 5) {
+                list.push_back(i);
+            }
+        }
+
+        auto it = list.cbegin();
+        it += 2;
+        list.insert(it, values.begin(), values.end());
+
+        assert(list.get_size() == 8);
+
+        for (int i = 0; i < 8; i++) {
+            assert(list[i] == i);
+        }
+    }
+    // Range Insert Across Chunks Test
+    {
+        ChunkList<std::string, 4> list;
+        std::vector<std::string> expected;
+        std::mt19937 rng(3);
+
+        for (int i = 0; i < 10; i++) {
+            list.push_back(std::to_string(i));
+            expected.push_back(std::to_string(i));
+        }
+        list.push_front("front");
+        expected.insert(expected.begin(), "front");
+        for (int round = 0; round < 60; round++) {
+            std::vector<std::string> values(rng() % 11);
+            for (auto& value : values) {
+                value = std::to_string(round) + "/" + std::to_string(rng() % 100);
+            }
+            int index = rng() % (expected.size() + 1);
+            auto it = list.cbegin();
+            if (index == static_cast<int>(expected.size())) {
+                it = list.cend();
+            }
+            else {
+                it += index;
+            }
+            if (round % 3 == 0) {
+                std::ostringstream words;
+                for (const auto& value : values) {
+                    words << value << ' ';
+                }
+                std::istringstream stream(words.str());
+                list.insert(it, std::istream_iterator<std::string>(stream), std::istream_iterator<std::string>());
+            }
+            else {
+                list.insert(it, values.begin(), values.end());
+            }
+            expected.insert(expected.begin() + index, values.begin(), values.end());
+        }
+
+        assert(list.get_size() == static_cast<int>(expected.size()));
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            assert(list[i] == expected[i]);
+        }
+        assert(list.back() == expected.back());
+    }
+    // Assign Range Test
+    {
+        ChunkList<int, 3> list(5, 4);
+        std::vector<int> values = { 9, 8, 7, 6 };
+
+        list.assign(values.begin(), values.end());
+
+        assert(list.get_size() == 4);
+
+        for (int i = 0; i < 4; i++) {
+            assert(list[i] == values[i]);
+        }
+    }
+    // Emplace Back Test
+    {
+        ChunkList<std::pair<int, std::string>, 3> list;
+
+        for (int i = 0; i < 5; i++) {
+            auto& element = list.emplace_back(i, std::string(i + 1, 'a'));
+            assert(element.first == i);
+        }
+
+        assert(list.get_size() == 5);
+        assert(list.back().second == "aaaaa");
+    }
+    // Emplace Test
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 0; i < 10; i++) {
+            if (i != 4) {
+                list.push_back(i);
+            }
+        }
+
+        auto it = list.cbegin();
+        it += 4;
+        auto inserted = list.emplace(it, 4);
+
+        assert(*inserted == 4);
+        assert(list.get_size() == 10);
+
+        for (int i = 0; i < 10; i++) {
+            assert(list[i] == i);
+        }
+
+        list.emplace_front(-1);
+        assert(list.front() == -1);
+        assert(list[10] == 9);
+    }
+    // Self Referencing Insert Test
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 0; i < 6; i++) {
+            list.push_back(i);
+        }
+
+        list.insert(list.cbegin() + 1, list[3]);
+
+        std::vector<int> expected = { 0, 3, 1, 2, 3, 4, 5 };
+        assert(list.get_size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); i++) {
+            assert(list[i] == expected[i]);
+        }
+
+        ChunkList<std::string, 3> strings;
+
+        for (int i = 0; i < 6; i++) {
+            strings.push_back(std::string(3, 'a' + i));
+        }
+
+        strings.emplace(strings.cbegin() + 2, strings[2]);
+        strings.insert(strings.cbegin() + 1, strings.back());
+
+        assert(strings.get_size() == 8);
+        assert(strings[1] == "fff" && strings[3] == "ccc" && strings[4] == "ccc");
+        assert(strings.back() == "fff");
+    }
+    // Insert At End Test
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 0; i < 3; i++) {
+            list.push_back(i);
+        }
+
+        auto inserted = list.insert(list.cend(), 3);
+
+        assert(*inserted == 3);
+        assert(list.get_size() == 4);
+        assert(list.back() == 3);
+    }
+    // Push Front Test
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 5; i < 10; i++) {
+            list.push_back(i);
+        }
+        for (int i = 4; i >= 0; i--) {
+            list.push_front(i);
+        }
+
+        assert(list.get_size() == 10);
+        assert(list.front() == 0);
+        assert(list.back() == 9);
+
+        for (int i = 0; i < 10; i++) {
+            assert(list[i] == i);
+        }
+    }
+    // Pop Front Test
+    {
+        ChunkList<int, 3> list;
+
+        for (int i = 0; i < 10; i++) {
+            list.push_back(i);
+        }
+        for (int i = 0; i < 4; i++) {
+            list.pop_front();
+        }
+
+        assert(list.get_size() == 6);
+        assert(list.front() == 4);
+
+        list.push_back(10);
+        list.push_front(3);
+
+        for (int i = 0; i < 8; i++) {
+            assert(list[i] == i + 3);
+        }
+
+        while (!list.empty()) {
+            list.pop_front();
+        }
+        list.push_back(42);
+        assert(list.front() == 42);
+    }
+    // Chunk Ring Test
+    {
+        ChunkRing<int, 4> ring(10);
+
+        assert(ring.capacity() >= 10);
+
+        for (int i = 0; i < 10; i++) {
+            ring.push_back(i);
+        }
+
+        assert(ring.get_size() == 10);
+        assert(ring.front() == 0);
+
+        for (int i = 10; i < 100; i++) {
+            ring.push_back(i);
+            assert(ring.get_size() >= 10);
+            assert(ring.back() == i);
+        }
+
+        int first = ring.front();
+        for (int i = 0; i < ring.get_size(); i++) {
+            assert(ring[i] == first + i);
+        }
+        assert(ring[ring.get_size() - 1] == 99);
+
+        const ChunkRing<int, 4>& const_ring = ring;
+        assert(const_ring.front() == first && const_ring.back() == 99);
+        int expected = first;
+        for (auto it = const_ring.begin(); it != const_ring.end(); ++it) {
+            assert(*it == expected++);
+        }
+        assert(expected == 100);
+
+        ring.pop_front_chunk();
+        assert(ring.front() == first + 4);
+
+        ring.clear();
+        assert(ring.empty() == true);
+    }
+    // Move Constructor Test
+    {
+        static_assert(std::is_nothrow_move_constructible<ChunkList<int, 3>>::value, "ChunkList move must be noexcept");
+
+        ChunkList<int, 3> first_list;
+        for (int i = 0; i < 5; i++) {
+            first_list.push_back(i);
+        }
+        int* first_element = &first_list[0];
+
+        ChunkList<int, 3> second_list(std::move(first_list));
+
+        assert(first_list.empty() == true);
+        assert(second_list.get_size() == 5);
+        assert(&second_list[0] == first_element);
+
+        Allocator<int> allocator;
+        ChunkList<int, 3> third_list(std::move(second_list), allocator);
+
+        assert(third_list.get_size() == 5);
+        assert(&third_list[0] == first_element);
+
+        std::vector<ChunkList<int, 3>> lists(1);
+        lists[0] = std::move(third_list);
+        lists.resize(10);
+        assert(&lists[0][0] == first_element);
+    }
+    // Assignment Test
+    {
+        ChunkList<int, 3> first_list;
+        ChunkList<int, 3> second_list(7, 1);
+        for (int i = 0; i < 5; i++) {
+            first_list.push_back(i);
+        }
+
+        second_list = first_list;
+        first_list.push_back(5);
+
+        assert(second_list.get_size() == 5);
+        for (int i = 0; i < 5; i++) {
+            assert(second_list[i] == i);
+        }
+
+        second_list = std::move(first_list);
+
+        assert(second_list.get_size() == 6);
+        assert(second_list.back() == 5);
+    }
+    // Comparison Test
+    {
+        ChunkList<int, 3> first_list;
+        ChunkList<int, 3> second_list;
+
+        for (int i = 0; i < 10; i++) {
+            first_list.push_back(i);
+        }
+        for (int i = 9; i >= 0; i--) {
+            second_list.push_front(i);
+        }
+
+        assert(first_list == second_list);
+        assert(!(first_list < second_list));
+        assert(first_list <= second_list);
+        std::hash<ChunkList<int, 3>> hasher;
+        assert(hasher(first_list) == hasher(second_list));
+
+        second_list.back() = 10;
+        assert(first_list != second_list);
+        assert(first_list < second_list);
+        assert(second_list > first_list);
+
+        second_list.pop_back();
+        assert(second_list < first_list);
+    }
+    // String Comparison Test
+    {
+        ChunkList<std::string, 2> first_list;
+        ChunkList<std::string, 2> second_list;
+
+        for (int i = 0; i < 5; i++) {
+            first_list.push_back(std::string(i + 1, 'a'));
+            second_list.push_back(std::string(i + 1, 'a'));
+        }
+
+        assert(first_list == second_list);
+        std::hash<ChunkList<std::string, 2>> hasher;
+        assert(hasher(first_list) == hasher(second_list));
+
+        second_list.front() = "b";
+        assert(first_list < second_list);
+    }
+    // Parallel For Each Test
+    {
+        ThreadPool pool(3);
+        ChunkList<int, 4> list;
+
+        for (int i = 0; i < 1000; i++) {
+            list.push_back(i);
+        }
+        list.push_front(-1);
+
+        std::atomic<long long> sum(0);
+        list.parallel_for_each([&sum](int value) { sum += value; }, pool);
+        assert(sum == 999 * 1000 / 2 - 1);
+
+        list.parallel_transform([](int value) { return value * 2; }, pool);
+
+        assert(list.front() == -2);
+        for (int i = 0; i < 1000; i++) {
+            assert(list[i + 1] == 2 * i);
+        }
+    }
+    // Nested Parallel For Test
+    {
+        ThreadPool pool(2);
+        ChunkList<long long, 4> list;
+
+        for (int i = 0; i < 100; i++) {
+            list.push_back(i);
+        }
+
+        // every outer range runs parallel algorithms on the same pool while the pool is busy
+        for (int round = 0; round < 50; round++) {
+            std::atomic<long long> total(0);
+            pool.parallel_for(8, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++) {
+                    std::atomic<long long> inner(0);
+                    pool.parallel_for(10, [&inner](std::size_t inner_first, std::size_t inner_last) {
+                        inner += inner_last - inner_first;
+                    });
+                    total += inner + list.parallel_reduce(0LL, std::plus<long long>(), pool);
+                }
+            });
+            assert(total == 8 * (10 + 99 * 100 / 2));
+        }
+    }
+    // Work Stealing Test
+    {
+        ThreadPool pool(3);
+        ChunkList<int, 4> list;
+
+        for (int i = 0; i < 1000; i++) {
+            list.push_back(i);
+        }
+
+        std::atomic<long long> sum(0);
+        list.parallel_for_each_stealing([&sum](int value) { sum += value; }, pool);
+        assert(sum == 999 * 1000 / 2);
+
+        std::vector<std::atomic<int>> visits(1000);
+        WorkStealingExecutor(pool).parallel_for(visits.size(), [&visits](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                visits[i]++;
+            }
+        });
+        for (auto& visit : visits) {
+            assert(visit == 1);
+        }
+    }
+    // Sort Test
+    {
+        ThreadPool pool(3);
+        ChunkList<int, 4> list;
+        ChunkList<int, 4> parallel_list;
+
+        for (int i = 0; i < 500; i++) {
+            list.push_back((i * 7919) % 503);
+            parallel_list.push_front((i * 7919) % 503);
+        }
+
+        list.sort();
+        parallel_list.parallel_sort(std::less<int>(), pool);
+
+        assert(list.get_size() == 500);
+        assert(list == parallel_list);
+        for (int i = 1; i < 500; i++) {
+            assert(list[i - 1] <= list[i]);
+        }
+
+        list.sort(std::greater<int>());
+        assert(list.front() == 502);
+    }
+    // Stable Sort Test
+    {
+        ThreadPool pool(3);
+        ChunkList<std::pair<int, int>, 3> list;
+
+        for (int i = 0; i < 300; i++) {
+            list.emplace_back(i % 7, i);
+        }
+
+        list.parallel_stable_sort([](const std::pair<int, int>& first, const std::pair<int, int>& second) {
+            return first.first < second.first;
+        }, pool);
+
+        for (int i = 1; i < 300; i++) {
+            assert(list[i - 1].first < list[i].first ||
+                (list[i - 1].first == list[i].first && list[i - 1].second < list[i].second));
+        }
+    }
+    // Radix Sort Test
+    {
+        ThreadPool pool(3);
+        ChunkList<int, 4> list;
+        ChunkList<double, 4> doubles;
+
+        for (int i = 0; i < 500; i++) {
+            list.push_front((i * 7919) % 503 - 250);
+            doubles.push_back(((i * 7919) % 503 - 250) / 8.0);
+        }
+
+        ChunkList<int, 4> expected(list);
+        expected.sort();
+        list.radix_sort(RadixIdentity(), pool);
+        doubles.radix_sort(RadixIdentity(), pool);
+
+        assert(list == expected);
+        for (int i = 1; i < 500; i++) {
+            assert(doubles[i - 1] <= doubles[i]);
+        }
+    }
+    // Radix Sort With Key Test
+    {
+        ThreadPool pool(3);
+        ChunkList<std::pair<unsigned, std::string>, 3> list;
+
+        for (unsigned i = 0; i < 300; i++) {
+            list.emplace_back(i % 7 * 1000, std::to_string(i));
+        }
+
+        list.radix_sort([](const std::pair<unsigned, std::string>& value) { return value.first; }, pool);
+
+        for (int i = 1; i < 300; i++) {
+            assert(list[i - 1].first <= list[i].first);
+            if (list[i - 1].first == list[i].first) {
+                assert(std::stoi(list[i - 1].second) < std::stoi(list[i].second));
+            }
+        }
+    }
+    // Parallel Reduce Test
+    {
+        ThreadPool pool(3);
+        ChunkList<int, 4> list;
+
+        assert(list.parallel_reduce(7, std::plus<int>(), pool) == 7);
+
+        for (int i = 0; i < 1000; i++) {
+            list.push_back(i);
+        }
+        list.push_front(-1);
+
+        assert(list.parallel_reduce(0LL, std::plus<long long>(), pool) == 999 * 1000 / 2 - 1);
+        assert(list.parallel_reduce(0, [](int lhs, int rhs) { return std::max(lhs, rhs); }, pool) == 999);
+    }
+    // Scan Test
+    {
+        ThreadPool pool(3);
+        ChunkList<int, 4> inclusive;
+        ChunkList<int, 4> exclusive;
+
+        for (int i = 1; i <= 100; i++) {
+            inclusive.push_back(i);
+            exclusive.push_back(i);
+        }
+        inclusive.push_front(0);
+        exclusive.push_front(0);
+
+        inclusive.inclusive_scan(std::plus<int>(), pool);
+        exclusive.exclusive_scan(10, std::plus<int>(), pool);
+
+        for (int i = 0; i <= 100; i++) {
+            assert(inclusive[i] == i * (i + 1) / 2);
+            assert(exclusive[i] == 10 + (i > 0 ? (i - 1) * i / 2 : 0));
+        }
+    }
+    // Transform Scan Test
+    {
+        ThreadPool pool(3);
+        ChunkList<std::string, 3> records;
+        ChunkList<std::size_t, 3> offsets;
+
+        for (int i = 0; i < 50; i++) {
+            records.push_back(std::string(i % 5, 'x'));
+        }
+        records.push_front("abc");
+
+        auto length = [](const std::string& value) { return value.size(); };
+        records.transform_exclusive_scan(offsets, std::size_t(0), std::plus<std::size_t>(), length, pool);
+
+        assert(offsets.get_size() == 51);
+        std::size_t expected = 0;
+        for (int i = 0; i < 51; i++) {
+            assert(offsets[i] == expected);
+            expected += records[i].size();
+        }
+
+        records.transform_inclusive_scan(offsets, std::plus<std::size_t>(), length, pool);
+        assert(offsets.get_size() == 51);
+        assert(offsets.back() == expected);
+    }
+    // SIMD Kernels Test
+    {
+        std::vector<std::int64_t> values;
+        for (int i = 0; i < 77; i++) {
+            values.push_back((i * 37) % 101 - 50);
+        }
+        ScalarKernels<std::int64_t> scalar;
+
+        for (int level = 0; level <= static_cast<int>(DetectSimdLevel()); level++) {
+            SimdKernelTable<std::int64_t> kernels = MakeKernelTable<std::int64_t>(static_cast<SimdLevel>(level));
+            for (std::size_t count = 1; count <= values.size(); count++) {
+                assert(kernels.sum(values.data(), count) == scalar.Sum(values.data(), count));
+                assert(kernels.min(values.data(), count) == scalar.Min(values.data(), count));
+                assert(kernels.max(values.data(), count) == scalar.Max(values.data(), count));
+                assert(kernels.count_equal(values.data(), count, 13) == scalar.CountEqual(values.data(), count, 13));
+                assert(kernels.find_first(values.data(), count, 13) == scalar.FindFirst(values.data(), count, 13));
+                assert(kernels.any_greater(values.data(), count, 45) == scalar.AnyGreater(values.data(), count, 45));
+            }
+        }
+    }
+    // SIMD Kernel Types Test
+    {
+        // integers get the vector kernels by size and signedness, not by their exact type
+        static_assert(HasSimdKernels<long long>::value && HasSimdKernels<long>::value && HasSimdKernels<int>::value,
+                      "signed 32- and 64-bit integers have SIMD kernels");
+        static_assert(!HasSimdKernels<unsigned>::value && !HasSimdKernels<short>::value,
+                      "other integers use the scalar kernels");
+        assert(GetSimdKernels<long long>().level == DetectSimdLevel());
+
+        ChunkList<long long, 37> list;
+        for (long long i = 0; i < 1000; i++) {
+            list.push_back(i * 3000000000LL - 1000);
+        }
+        assert(list.sum() == 3000000000LL * (999 * 1000 / 2) - 1000 * 1000);
+        assert(list.min_value() == -1000 && list.max_value() == 999 * 3000000000LL - 1000);
+        assert(list.count_equal(2999999000LL) == 1 && list.find_first(2999999000LL) == 1);
+        assert(list.any_greater(998 * 3000000000LL) && !list.any_greater(999 * 3000000000LL));
+    }
+    // SIMD NaN Test
+    {
+        // min and max skip NaN at every level, wherever it is in the span, and only return NaN without other values
+        auto check_nan = [](auto zero) {
+            using value_type = decltype(zero);
+            const value_type nan = std::numeric_limits<value_type>::quiet_NaN();
+
+            for (int level = 0; level <= static_cast<int>(DetectSimdLevel()); level++) {
+                SimdKernelTable<value_type> kernels = MakeKernelTable<value_type>(static_cast<SimdLevel>(level));
+                for (std::size_t count = 2; count <= 40; count++) {
+                    for (std::size_t position = 0; position < count; position++) {
+                        std::vector<value_type> values(count);
+                        value_type expected_min = std::numeric_limits<value_type>::max();
+                        value_type expected_max = std::numeric_limits<value_type>::lowest();
+                        for (std::size_t i = 0; i < count; i++) {
+                            values[i] = static_cast<value_type>(static_cast<int>(i * 5 % 11) - 5);
+                            if (i != position) {
+                                expected_min = std::min(expected_min, values[i]);
+                                expected_max = std::max(expected_max, values[i]);
+                            }
+                        }
+                        values[position] = nan;
+                        assert(kernels.min(values.data(), count) == expected_min);
+                        assert(kernels.max(values.data(), count) == expected_max);
+                    }
+                }
+                std::vector<value_type> only_nan(40, nan);
+                assert(std::isnan(kernels.min(only_nan.data(), only_nan.size())));
+                assert(std::isnan(kernels.max(only_nan.data(), only_nan.size())));
+            }
+        };
+        check_nan(0.0f);
+        check_nan(0.0);
+
+        ChunkList<double, 7> doubles;
+        doubles.push_back(std::numeric_limits<double>::quiet_NaN());
+        for (int i = 0; i < 30; i++) {
+            doubles.push_back(i);
+        }
+        assert(doubles.min_value() == 0.0);
+        assert(doubles.max_value() == 29.0);
+    }
+    // SIMD ChunkList Test
+    {
+        ChunkList<std::int32_t, 37> ints;
+        ChunkList<double, 37> doubles;
+
+        for (int i = 0; i < 1000; i++) {
+            ints.push_back(i % 100 - 10);
+            doubles.push_back(i * 0.5);
+        }
+        ints.push_front(-20);
+        doubles.push_front(-1.0);
+
+        assert(ints.sum() == 10 * (99 * 100 / 2 - 1000) - 20);
+        assert(ints.min_value() == -20);
+        assert(ints.max_value() == 89);
+        assert(ints.count_equal(5) == 10);
+        assert(ints.find_first(5) == 16);
+        assert(ints.find_first(1000) == -1);
+        assert(ints.any_greater(88) && !ints.any_greater(89));
+
+        assert(doubles.sum() == 999 * 1000 / 4.0 - 1.0);
+        assert(doubles.min_value() == -1.0);
+        assert(doubles.max_value() == 499.5);
+        assert(doubles.find_first(250.0) == 501);
+        assert(doubles.count_equal(0.25) == 0);
+    }
+    // Erase Test
+    {
+        ChunkList<std::string, 3> list;
+
+        for (int i = 0; i < 10; i++) {
+            list.push_back(std::to_string(i));
+        }
+        list.push_front("-1");
+
+        auto it = list.cbegin();
+        it += 3;
+        auto next = list.erase(it);
+
+        assert(*next == "3");
+        assert(list.get_size() == 10);
+        assert(list.front() == "-1");
+        assert(list[2] == "1");
+        for (int i = 3; i < 10; i++) {
+            assert(list[i] == std::to_string(i));
+        }
+
+        it = list.cbegin();
+        it += 9;
+        list.erase(it);
+        assert(list.get_size() == 9);
+        assert(list.back() == "8");
+    }
+    // Zoned Chunk List Test
+    {
+        ZonedChunkList<std::int64_t, 16> list;
+        std::vector<std::int64_t> values;
+
+        for (int i = 0; i < 2000; i++) {
+            values.push_back(i * 10 + i % 7);
+        }
+        list.append(values.begin(), values.begin() + 1000);
+        for (int i = 1000; i < 2000; i++) {
+            list.push_back(values[i]);
+        }
+
+        assert(list.count_in(500, 999) == 50);
+        assert(list.find_first_in(500, 999) == 50);
+        assert(list.find_first_in(-10, -1) == -1);
+        assert(list.count_candidate_chunks(500, 999) <= 5);
+
+        list.insert(100, 5);
+        list.erase(0);
+        list.push_front(-100);
+        list.set(500, 30000);
+        list.pop_back();
+
+        values.insert(values.begin() + 100, 5);
+        values.erase(values.begin());
+        values.insert(values.begin(), -100);
+        values[500] = 30000;
+        values.pop_back();
+
+        for (std::int64_t low = -200; low < 31000; low += 777) {
+            std::int64_t high = low + 1500;
+            std::size_t expected_count = 0;
+            int expected_first = -1;
+            for (std::size_t i = 0; i < values.size(); i++) {
+                if (values[i] >= low && values[i] <= high) {
+                    expected_first = expected_first < 0 ? static_cast<int>(i) : expected_first;
+                    expected_count++;
+                }
+            }
+            assert(list.count_in(low, high) == expected_count);
+            assert(list.find_first_in(low, high) == expected_first);
+        }
+
+        std::vector<std::int64_t> found;
+        list.for_each_in(0, 100, [&found](std::int64_t value) { found.push_back(value); });
+        assert((found == std::vector<std::int64_t>{ 11, 22, 33, 44, 55, 66, 70, 81, 92, 5 }));
+    }
+    // Concurrent Zone Query Test
+    {
+        ZonedChunkList<std::int64_t, 16> list;
+        for (int i = 0; i < 4000; i++) {
+            list.push_back(i);
+        }
+        for (int i = 0; i < 4000; i += 16) {
+            list.set(i, i);
+        }
+
+        // every chunk starts stale, the readers race to rebuild them
+        std::atomic<int> wrong{ 0 };
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; r++) {
+            readers.emplace_back([&list, &wrong, r] {
+                for (int low = r; low < 4000; low += 97) {
+                    if (list.count_in(low, low + 49) != static_cast<std::size_t>(std::min(50, 4000 - low))) {
+                        wrong.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(wrong.load() == 0);
+    }
+    // Aggregated Chunk List Test
+    {
+        AggregatedChunkList<long long, 8> sums;
+        std::vector<long long> values;
+
+        for (int i = 0; i < 100; i++) {
+            values.push_back(i * i % 37);
+        }
+        sums.append(values.begin(), values.begin() + 50);
+        for (int i = 50; i < 100; i++) {
+            sums.push_back(values[i]);
+        }
+
+        sums[10] = 1000;
+        sums.At(63) = sums[64];
+        sums.insert(20, 7);
+        sums.erase(3);
+        sums.pop_back();
+        values[10] = 1000;
+        values[63] = values[64];
+        values.insert(values.begin() + 20, 7);
+        values.erase(values.begin() + 3);
+        values.pop_back();
+
+        for (std::size_t first = 0; first <= values.size(); first += 3) {
+            for (std::size_t last = first; last <= values.size(); last += 5) {
+                long long expected = 0;
+                for (std::size_t i = first; i < last; i++) {
+                    expected += values[i];
+                }
+                assert(sums.range_aggregate(first, last) == expected);
+            }
+        }
+        assert(sums.aggregate() == sums.range_aggregate(0, values.size()));
+    }
+    // String Emplace Test
+    {
+        ChunkList<std::string, 2> list;
+
+        for (int i = 0; i < 6; i++) {
+            list.push_back(std::to_string(i));
+        }
+        auto it = list.cbegin();
+        it += 1;
+        list.emplace(it, "x");
+
+        assert(list.get_size() == 7);
+        assert(list[1] == "x");
+        assert(list[2] == "1");
+        assert(list.back() == "5");
+    }
+    // Non-Commutative Aggregate Test
+    {
+        AggregatedChunkList<std::string, 3> text;
+
+        for (char c = 'a'; c <= 'z'; c++) {
+            text.push_back(std::string(1, c));
+        }
+        text[4] = "E";
+
+        assert(text.range_aggregate(2, 9) == "cdEfghi");
+        assert(text.range_aggregate(5, 5).empty());
+        assert(text.aggregate() == "abcdEfghijklmnopqrstuvwxyz");
+
+        auto minimum = [](int lhs, int rhs) { return std::min(lhs, rhs); };
+        AggregatedChunkList<int, 4, decltype(minimum)> minimums(minimum, 1 << 30);
+        for (int i = 0; i < 40; i++) {
+            minimums.push_back(100 - i);
+        }
+        minimums[5] = -1;
+
+        assert(minimums.range_aggregate(0, 10) == -1);
+        assert(minimums.range_aggregate(6, 30) == 71);
+    }
+    // Sorted Chunk List Test
+    {
+        SortedChunkList<int, 8> list;
+        std::vector<int> values;
+
+        assert(list.lower_bound(3) == list.end());
+        assert(!list.erase(3));
+
+        for (int i = 0; i < 500; i++) {
+            int value = (i * 7919) % 211;
+            list.insert(value);
+            values.insert(std::upper_bound(values.begin(), values.end(), value), value);
+        }
+        for (int i = 0; i < 300; i++) {
+            int value = (i * 31) % 211;
+            assert(list.erase(value) == (std::find(values.begin(), values.end(), value) != values.end()));
+            auto found = std::lower_bound(values.begin(), values.end(), value);
+            if (found != values.end() && *found == value) {
+                values.erase(found);
+            }
+        }
+
+        assert(list.get_size() == static_cast<int>(values.size()));
+        assert(std::equal(list.begin(), list.end(), values.begin()));
+        assert(list.front() == values.front() && list.back() == values.back());
+        for (int key = -1; key <= 212; key++) {
+            auto expected = std::lower_bound(values.begin(), values.end(), key);
+            auto found = list.lower_bound(key);
+            assert((found == list.end()) == (expected == values.end()));
+            assert(found == list.end() || *found == *expected);
+            assert(list.count(key) == static_cast<std::size_t>(std::count(values.begin(), values.end(), key)));
+        }
+        assert(list.get_chunk_count() <= values.size() / 2 + 1);
+    }
+    // Sorted Chunk List Stability Test
+    {
+        auto by_key = [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.first < rhs.first; };
+        SortedChunkList<std::pair<int, int>, 4, decltype(by_key)> list(by_key);
+
+        for (int i = 0; i < 40; i++) {
+            list.insert({ i % 3, i });
+        }
+
+        auto it = list.lower_bound({ 1, 0 });
+        for (int i = 1; i < 40; i += 3, ++it) {
+            assert(it->first == 1 && it->second == i);
+        }
+        assert(list.upper_bound({ 1, 0 }) == it);
+
+        auto next = list.erase(list.find({ 2, 0 }));
+        assert(next->first == 2 && next->second == 5);
+    }
+    // Bloom Chunk List Test
+    {
+        BloomChunkList<std::uint64_t, 64> list;
+        std::vector<std::uint64_t> values;
+
+        for (std::uint64_t i = 0; i < 5000; i++) {
+            values.push_back(i * 2654435761ULL);
+        }
+        list.append(values.begin(), values.begin() + 2500);
+        for (std::size_t i = 2500; i < values.size(); i++) {
+            list.push_back(values[i]);
+        }
+
+        assert(list.find(values[1234]) == 1234);
+        assert(list.contains(values[4999]));
+        assert(!list.contains(1));
+        assert(list.count_candidate_chunks(1) <= 10);
+
+        list.erase(1234);
+        list.insert(10, 1);
+        list.set(4000, 3);
+        list.pop_front();
+        values.erase(values.begin() + 1234);
+        values.insert(values.begin() + 10, 1);
+        values[4000] = 3;
+        values.erase(values.begin());
 
+        for (std::size_t i = 0; i < values.size(); i += 7) {
+            assert(list.find(values[i]) == static_cast<int>(i));
+        }
+        assert(list.find(1) == 9);
+        assert(list.count(3) == 1);
+        assert(!list.contains(2654435761ULL * 1234));
+        assert(!list.contains(2654435761ULL * 4000));
+    }
+    // Summarized Chunk List Copy Test
+    {
+        ZonedChunkList<int, 4> zoned;
+        BloomChunkList<int, 4> bloom;
+        for (int i = 0; i < 40; i++) {
+            zoned.push_back(i);
+            bloom.push_back(i);
+        }
+        zoned.erase(5);
+        bloom.erase(5);
+
+        ZonedChunkList<int, 4> zoned_copy(zoned);
+        BloomChunkList<int, 4> bloom_copy(bloom);
+        zoned_copy.set(0, 100);
+        bloom_copy.set(0, 100);
+        assert(zoned.count_in(100, 100) == 0 && zoned_copy.count_in(100, 100) == 1);
+        assert(!bloom.contains(100) && bloom_copy.contains(100));
+        assert(zoned_copy.count_in(0, 39) == 38 && !bloom_copy.contains(5) && bloom_copy.find(39) == 38);
+
+        // the head chunk of the source starts at an offset, the copy does not
+        zoned.push_front(-1);
+        bloom.push_front(-1);
+        zoned_copy = zoned;
+        bloom_copy = bloom;
+        assert(zoned_copy.count_in(-1, 3) == 5 && zoned_copy.find_first_in(39, 39) == 39);
+        assert(bloom_copy.find(-1) == 0 && bloom_copy.find(39) == 39);
+
+        ZonedChunkList<int, 4> zoned_moved(std::move(zoned_copy));
+        BloomChunkList<int, 4> bloom_moved(std::move(bloom_copy));
+        assert(zoned_moved.count_in(-1, 39) == 40 && bloom_moved.count(7) == 1);
+        zoned_copy = std::move(zoned_moved);
+        bloom_copy = std::move(bloom_moved);
+        zoned_copy.push_back(50);
+        bloom_copy.push_back(50);
+        assert(zoned_copy.count_in(40, 50) == 1 && bloom_copy.find(50) == 40);
+    }
+    // Chunk Hash Map Test
+    {
+        ChunkHashMap<int, int, 4> map;
+        for (int i = 0; i < 10000; i++) {
+            assert(map.insert(i * 7, i));
+        }
+        assert(!map.insert(7, 0));
+        assert(map.get_size() == 10000);
+        assert(map.bucket_count() * 4 * 3 / 4 >= 10000);
+        for (int i = 0; i < 10000; i++) {
+            assert(*map.find(i * 7) == i);
+        }
+        assert(map.find(1) == nullptr);
+
+        for (int i = 0; i < 10000; i += 2) {
+            assert(map.erase(i * 7));
+        }
+        assert(!map.erase(0));
+        assert(map.get_size() == 5000);
+        for (int i = 0; i < 10000; i++) {
+            assert(map.contains(i * 7) == (i % 2 == 1));
+        }
+
+        map[3] += 5;
+        map.At(7) = 42;
+        assert(map.At(3) == 5 && *map.find(7) == 42);
+        long long key_sum = 0;
+        map.for_each([&key_sum](const int& key, const int&) {
+            key_sum += key;
+        });
+        assert(key_sum == 3 + 7LL * 5000 * 5000);
+
+        bool thrown = false;
+        try {
+            map.At(0);
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+        map.clear();
+        assert(map.empty() && !map.contains(3));
+    }
+    // String Hash Map Test
+    {
+        ChunkHashMap<std::string, std::string, 2> map;
+        for (int i = 0; i < 500; i++) {
+            map[std::to_string(i)] = std::string(20, static_cast<char>('a' + i % 26));
+        }
+        for (int i = 0; i < 500; i += 3) {
+            map.erase(std::to_string(i));
+        }
+        for (int i = 0; i < 500; i++) {
+            const std::string* found = map.find(std::to_string(i));
+            assert((found != nullptr) == (i % 3 != 0));
+            assert(found == nullptr || *found == std::string(20, static_cast<char>('a' + i % 26)));
+        }
+    }
+
+    // Concurrent Chunk List Test
+    {
+        const int producers = 4;
+        const int per_producer = 20000;
+        ConcurrentChunkList<int, 64> list;
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&list, p] {
+                for (int i = 0; i < per_producer; i++) {
+                    list.push_back(p * per_producer + i);
+                }
+            });
+        }
+        // a reader walks the published prefix while the producers append
+        std::thread reader([&list, &done] {
+            std::size_t last_count = 0;
+            while (!done.load()) {
+                std::size_t count = 0;
+                list.for_each([&count](const int&) {
+                    count++;
+                });
+                assert(count >= last_count);
+                last_count = count;
+            }
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        done.store(true);
+        reader.join();
+
+        assert(list.get_size() == producers * per_producer);
+        std::vector<int> last_seen(producers, -1);
+        std::size_t count = 0;
+        list.for_each([&](const int& value) {
+            int producer = value / per_producer;
+            assert(value > last_seen[producer]);
+            last_seen[producer] = value;
+            count++;
+        });
+        assert(count == producers * per_producer);
+        for (int p = 0; p < producers; p++) {
+            assert(last_seen[p] == (p + 1) * per_producer - 1);
+        }
+
+        list.clear();
+        assert(list.empty());
+        list.emplace_back(7);
+        list.for_each([](const int& value) {
+            assert(value == 7);
+        });
+    }
+    // Concurrent Chunk Array Test
+    {
+        const int target = 50000;
+        ConcurrentChunkArray<std::atomic<int>, 32> counters;
+        counters.grow_by(100);
+        std::atomic<int>& first = counters.At(0);
+        std::atomic<bool> done{ false };
+
+        // readers bump counters below the size they saw while the array grows under them
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; r++) {
+            readers.emplace_back([&counters, &done] {
+                std::size_t pos = 0;
+                while (!done.load()) {
+                    std::size_t size = counters.get_size();
+                    counters[pos % size].fetch_add(1);
+                    pos += 7;
+                }
+            });
+        }
+        std::thread grower([&counters] {
+            for (int i = 100; i < target; i += 100) {
+                counters.grow_by(100);
+            }
+        });
+        grower.join();
+        done.store(true);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        assert(counters.get_size() == target);
+        assert(&counters.At(0) == &first);
+        first.fetch_add(1);
+        assert(counters[0].load() >= 1);
+
+        ConcurrentChunkArray<std::string, 4> names;
+        names.grow_by(3, std::string("a"));
+        std::string& name = names.emplace_back("b");
+        names.grow_to_at_least(100);
+        assert(&names.At(3) == &name && name == "b");
+        assert(names.get_size() == 100 && names[2] == "a" && names[99].empty());
+        names.grow_to_at_least(10);
+        assert(names.get_size() == 100);
+
+        bool thrown = false;
+        try {
+            names.At(100);
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        // move-only elements are moved in, not copied
+        ConcurrentChunkArray<std::unique_ptr<int>, 4> owners;
+        for (int i = 0; i < 10; i++) {
+            std::unique_ptr<int>& owner = owners.emplace_back(std::unique_ptr<int>(new int(i)));
+            assert(*owner == i);
+        }
+        std::unique_ptr<int> last(new int(10));
+        owners.push_back(std::move(last));
+        assert(!last && owners.get_size() == 11 && *owners[10] == 10 && *owners[3] == 3);
+    }
+    // Chunk Queue Test
+    {
+        ChunkQueue<std::string, 4> queue;
+        std::string value;
+        assert(queue.empty() && !queue.try_pop(value));
+        for (int i = 0; i < 100; i++) {
+            queue.push(std::to_string(i));
+        }
+        for (int i = 0; i < 60; i++) {
+            assert(queue.try_pop(value) && value == std::to_string(i));
+        }
+        for (int i = 100; i < 150; i++) {
+            queue.emplace(std::to_string(i));
+        }
+        for (int i = 60; i < 150; i++) {
+            assert(queue.try_pop(value) && value == std::to_string(i));
+        }
+        assert(queue.empty() && !queue.try_pop(value));
+        queue.push("left for the destructor");
+    }
+    // Concurrent Chunk Queue Test
+    {
+        const int threads = 4;
+        const int per_producer = 20000;
+        ChunkQueue<int, 16> queue;
+        std::vector<std::atomic<int>> seen(threads * per_producer);
+        std::atomic<int> popped{ 0 };
+        std::vector<std::thread> workers;
+        for (int p = 0; p < threads; p++) {
+            workers.emplace_back([&queue, p] {
+                for (int i = 0; i < per_producer; i++) {
+                    queue.push(p * per_producer + i);
+                }
+            });
+        }
+        for (int c = 0; c < threads; c++) {
+            workers.emplace_back([&] {
+                // every consumer sees the values of one producer in the order they were pushed
+                std::vector<int> last(threads, -1);
+                int value;
+                while (popped.load() < threads * per_producer) {
+                    if (queue.try_pop(value)) {
+                        assert(value > last[value / per_producer]);
+                        last[value / per_producer] = value;
+                        seen[value].fetch_add(1);
+                        popped.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (auto& count : seen) {
+            assert(count.load() == 1);
+        }
+        assert(queue.empty());
+    }
+    // SPSC Chunk Queue Test
+    {
+        SpscChunkQueue<std::string, 4> queue;
+        std::string value;
+        assert(!queue.try_pop(value));
+        for (int i = 0; i < 10; i++) {
+            queue.push(std::to_string(i));
+        }
+        assert(queue.try_pop(value) && value == "0");
+
+        std::string* values;
+        assert(queue.front_span(values) == 3 && values[0] == "1" && values[2] == "3");
+        queue.pop_span(2);
+        assert(queue.front_span(values) == 1 && values[0] == "3");
+        queue.pop_span(1);
+        std::vector<std::string> taken;
+        while (queue.consume_span([&taken](const std::string* span, std::size_t count) {
+            taken.insert(taken.end(), span, span + count);
+        }) > 0) {}
+        assert(taken.size() == 6 && taken.front() == "4" && taken.back() == "9");
+        assert(!queue.try_pop(value) && queue.front_span(values) == 0);
+        queue.push("left for the destructor");
+    }
+    // Concurrent SPSC Chunk Queue Test
+    {
+        const int count = 200000;
+        SpscChunkQueue<int, 64> queue;
+        std::thread producer([&queue] {
+            for (int i = 0; i < count; i++) {
+                queue.push(i);
+            }
+        });
+        int expected = 0;
+        while (expected < count) {
+            queue.consume_span([&expected](const int* values, std::size_t size) {
+                for (std::size_t i = 0; i < size; i++) {
+                    assert(values[i] == expected);
+                    expected++;
+                }
+            });
+        }
+        producer.join();
+        int value;
+        assert(!queue.try_pop(value));
+    }
+    // Snapshot Chunk List Test
+    {
+        SnapshotChunkList<std::string, 4> list;
+        for (int i = 0; i < 10; i++) {
+            list.push_back(std::to_string(i));
+        }
+        auto before = list.snapshot();
+        list.erase(5);
+        list.erase(0);
+        list.erase(7);
+        list.erase(6);
+        list.push_back("10");
+        list.erase(4);
+
+        std::vector<std::string> old_values;
+        before.for_each([&old_values](const std::string& value) {
+            old_values.push_back(value);
+        });
+        assert(old_values.size() == 10 && old_values[0] == "0" && old_values[9] == "9");
+        assert(list.get_retired_count() > 0);
+
+        std::vector<std::string> values;
+        list.snapshot().for_each([&values](const std::string& value) {
+            values.push_back(value);
+        });
+        assert((values == std::vector<std::string>{ "1", "2", "3", "4", "7", "10" }));
+
+        before = list.snapshot();
+        list.reclaim();
+        assert(list.get_retired_count() == 0);
+        while (!list.empty()) {
+            list.erase(list.get_size() - 1);
+        }
+        assert(before.get_size() == 6 && list.snapshot().empty());
+        list.push_back("again");
+        assert(list.get_size() == 1);
+    }
+    // Concurrent Snapshot Test
+    {
+        SnapshotChunkList<int, 16> list;
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; r++) {
+            readers.emplace_back([&list, &done] {
+                while (!done.load()) {
+                    // the writer keeps the list ascending, so every snapshot has to be ascending too
+                    auto snapshot = list.snapshot();
+                    std::size_t count = 0;
+                    int last = -1;
+                    snapshot.for_each([&](const int& value) {
+                        assert(value > last);
+                        last = value;
+                        count++;
+                    });
+                    assert(count == snapshot.get_size());
+                }
+            });
+        }
+        std::mt19937 rng(3);
+        for (int i = 0; i < 20000; i++) {
+            list.push_back(i);
+            if (i % 3 == 0) {
+                list.erase(rng() % list.get_size());
+            }
+        }
+        done.store(true);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        list.reclaim();
+        assert(list.get_retired_count() == 0);
+    }
+    // Striped Chunk List Test
+    {
+        StripedChunkList<std::string, 4, 3> list;
+        std::vector<std::string> values;
+        for (int i = 0; i < 30; i++) {
+            values.push_back(std::to_string(i));
+        }
+        list.append(values.begin(), values.end());
+        list.push_back("30");
+        list.insert(0, "first");
+        list.erase(10);
+        list.pop_back();
+        list.store(5, "five");
+        list.update(6, [](std::string& value) {
+            value += "!";
+        });
+        assert(list.get_size() == 30);
+        assert(list.load(0) == "first" && list.load(1) == "0" && list.load(5) == "five" && list.load(6) == "5!");
+        assert(list.load(10) == "10" && list.load(29) == "29");
+        assert(list.update(29, [](const std::string& value) { return value.size(); }) == 2);
+        list.with_list([](const ChunkList<std::string, 4>& whole) {
+            assert(whole.get_size() == 30 && whole.back() == "29");
+        });
+
+        bool thrown = false;
+        try {
+            list.load(30);
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+        list.clear();
+        assert(list.empty());
+    }
+    // Concurrent Striped Chunk List Test
+    {
+        StripedChunkList<long long, 16, 8> list;
+        std::vector<long long> zeros(1000, 0);
+        list.append(zeros.begin(), zeros.end());
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&list, t] {
+                std::mt19937 rng(t);
+                for (int i = 0; i < 20000; i++) {
+                    list.update(rng() % 1000, [](long long& value) {
+                        value++;
+                    });
+                }
+            });
+        }
+        // structural changes past the updated range while the updates run
+        threads.emplace_back([&list] {
+            for (int i = 0; i < 200; i++) {
+                list.push_back(0);
+                list.insert(1000, 0);
+                list.erase(1000);
+            }
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        long long total = 0;
+        for (int i = 0; i < list.get_size(); i++) {
+            total += list.load(i);
+        }
+        assert(list.get_size() == 1200 && total == 4 * 20000);
+    }
+    // Block Cache Test
+    {
+        BlockCache& cache = BlockCache::Instance();
+        void* block = cache.allocate(3000);
+        static_cast<char*>(block)[2999] = 1;
+        cache.deallocate(block);
+        void* reused = cache.allocate(2500);
+        assert(reused == block);
+        cache.deallocate(reused);
+
+        // a block freed on another thread goes back to the thread that allocated it
+        std::thread owner([&cache] {
+            void* block = cache.allocate(5000);
+            std::thread([&cache, block] {
+                cache.deallocate(block);
+            }).join();
+            std::vector<void*> blocks;
+            bool returned = false;
+            for (int i = 0; i <= 2 * BlockCache::MagazineSize && !returned; i++) {
+                blocks.push_back(cache.allocate(5000));
+                returned = blocks.back() == block;
+            }
+            assert(returned);
+            for (auto pointer : blocks) {
+                cache.deallocate(pointer);
+            }
+        });
+        owner.join();
+
+        std::size_t depot_bytes = cache.get_depot_bytes(20000);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 3 * BlockCache::MagazineSize; i++) {
+            blocks.push_back(cache.allocate(20000));
+        }
+        for (auto pointer : blocks) {
+            cache.deallocate(pointer);
+        }
+        assert(cache.get_depot_bytes(20000) > depot_bytes);
+
+        // the depot of a large class keeps only a few blocks
+        const std::size_t large_block = std::size_t(1) << 20;
+        blocks.clear();
+        for (int i = 0; i < 40; i++) {
+            blocks.push_back(cache.allocate(large_block));
+        }
+        for (auto pointer : blocks) {
+            cache.deallocate(pointer);
+        }
+        assert(cache.get_depot_bytes(large_block) > 0);
+        assert(cache.get_depot_bytes(large_block) <= BlockCache::MaxDepotBytes);
+
+        void* large = cache.allocate(std::size_t(3) << 20);
+        static_cast<char*>(large)[(std::size_t(3) << 20) - 1] = 1;
+        cache.deallocate(large);
+        cache.deallocate(nullptr);
+    }
+    // Caching Allocator Test
+    {
+        ChunkList<int, 64, CachingAllocator<int>> cached;
+        ChunkList<int, 64> plain;
+        for (int i = 0; i < 1000; i++) {
+            cached.push_back(i);
+            plain.push_back(i);
+        }
+        cached.erase(cached.cbegin() + 10);
+        cached.push_front(-1);
+        assert(cached.get_allocator().uses_block_cache());
+        assert(!plain.get_allocator().uses_block_cache());
+        assert(Allocator<int>() != CachingAllocator<int>());
+
+        ChunkList<int, 64, CachingAllocator<int>> copy(cached);
+        ChunkList<int, 64, CachingAllocator<int>> filled(100, 7);
+        assert(copy.get_size() == 1000 && copy[0] == -1 && copy[11] == 11);
+        assert(filled.get_allocator().uses_block_cache() && filled[99] == 7);
+        cached.clear();
+        cached.push_back(5);
+        assert(cached.get_allocator().uses_block_cache() && cached.front() == 5);
+    }
+    // Chunk List Builder Test
+    {
+        // sizes that leave partly filled tails in front of some builders
+        const int sizes[] = { 7, 0, 8, 13, 3, 1 };
+        std::vector<ChunkList<std::string, 4>::Builder> builders(6);
+        std::vector<std::thread> threads;
+        int first_value = 0;
+        for (int t = 0; t < 6; t++) {
+            threads.emplace_back([&builders, t, first_value, &sizes] {
+                for (int i = 0; i < sizes[t]; i++) {
+                    builders[t].push_back(std::to_string(first_value + i));
+                }
+            });
+            first_value += sizes[t];
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ChunkList<std::string, 4> list = ChunkList<std::string, 4>::merge(builders);
+        assert(list.get_size() == 32);
+        for (int i = 0; i < 32; i++) {
+            assert(list.At(i) == std::to_string(i));
+        }
+        for (auto& builder : builders) {
+            assert(builder.empty());
+        }
+        list.push_back("32");
+        list.push_front("-1");
+        list.erase(list.cbegin() + 10);
+        assert(list.get_size() == 33 && list.front() == "-1" && list.At(10) == "10" && list.back() == "32");
+
+        ChunkList<int, 4>::Builder first;
+        ChunkList<int, 4>::Builder second;
+        for (int i = 0; i < 8; i++) {
+            first.push_back(i);
+            second.emplace_back(8 + i);
+        }
+        ChunkList<int, 4> aligned = ChunkList<int, 4>::merge(first, second);
+        assert(aligned.get_size() == 16 && aligned.At(7) == 7 && aligned.At(8) == 8 && aligned.back() == 15);
+
+        ChunkList<int, 4>::Builder empty;
+        ChunkList<int, 4> merged_empty = ChunkList<int, 4>::merge(empty);
+        assert(merged_empty.empty());
+    }
 
     std::cout << "All tests passed." << std::endl;
 
@@ -0,0 +1,173 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Growable array whose elements never move: growth only adds chunks, so references returned by At
+    // and operator[] stay valid for the lifetime of the array. Indexing is safe from any number of
+    // threads while one or more threads grow the array, for indices below a size the reader has seen.
+    // The chunk directory is published with a release store; a full directory is replaced by a copy of
+    // twice the capacity and the old one is kept until destruction, so readers never see it freed.
+    // Elements only need to be constructible in place, std::atomic<T> works.
+    template <typename T, int N, typename Allocator = Allocator<T>>
+    class ConcurrentChunkArray {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+    private:
+        struct Directory {
+            size_type capacity;
+            std::unique_ptr<Chunk<value_type>*[]> chunks;
+
+            explicit Directory(size_type chunk_capacity)
+                : capacity(chunk_capacity), chunks(new Chunk<value_type>*[chunk_capacity]()) {}
+        };
+
+        std::atomic<size_type> size{ 0 };
+        std::atomic<Directory*> directory;
+        std::vector<std::unique_ptr<Directory>> directories; //every directory ever published, the current one last
+        size_type chunk_count = 0;
+        std::mutex grow_mutex;
+        Allocator allocator;
+
+    public:
+        explicit ConcurrentChunkArray(const Allocator& alloc = Allocator()) : allocator(alloc) {
+            directories.emplace_back(new Directory(8));
+            directory.store(directories.back().get(), std::memory_order_relaxed);
+        }
+
+        ConcurrentChunkArray(const ConcurrentChunkArray& other) = delete;
+
+        ConcurrentChunkArray& operator=(const ConcurrentChunkArray& other) = delete;
+
+        ~ConcurrentChunkArray() {
+            Directory* current = directory.load(std::memory_order_relaxed);
+            size_type count = size.load(std::memory_order_relaxed);
+            for (size_type i = 0; i < count; i++) {
+                current->chunks[i / N]->list[i % N].~value_type();
+            }
+            for (size_type i = 0; i < chunk_count; i++) {
+                Chunk<value_type>* chunk = current->chunks[i];
+                chunk->allocator.deallocate(chunk->list, chunk->size);
+                delete chunk;
+            }
+        }
+
+        size_type get_size() const noexcept {
+            return size.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept {
+            return get_size() == 0;
+        }
+
+        reference At(size_type pos) {
+            if (pos >= get_size()) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            return (*this)[pos];
+        }
+
+        const_reference At(size_type pos) const {
+            if (pos >= get_size()) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            return (*this)[pos];
+        }
+
+        reference operator[](size_type pos) noexcept {
+            return directory.load(std::memory_order_acquire)->chunks[pos / N]->list[pos % N];
+        }
+
+        const_reference operator[](size_type pos) const noexcept {
+            return directory.load(std::memory_order_acquire)->chunks[pos / N]->list[pos % N];
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            std::lock_guard<std::mutex> lock(grow_mutex);
+            size_type pos = size.load(std::memory_order_relaxed);
+            Reserve(pos + 1);
+            value_type* slot = directory.load(std::memory_order_relaxed)->chunks[pos / N]->list + pos % N;
+            ::new (static_cast<void*>(slot)) value_type(std::forward<Args>(args)...);
+            size.store(pos + 1, std::memory_order_release);
+            return *slot;
+        }
+
+        // appends count elements constructed from args and returns the index of the first one;
+        // readers see them once the whole batch is constructed
+        template <typename... Args>
+        size_type grow_by(size_type count, const Args&... args) {
+            std::lock_guard<std::mutex> lock(grow_mutex);
+            size_type first = size.load(std::memory_order_relaxed);
+            Construct(first, count, args...);
+            return first;
+        }
+
+        // grows to at least new_size value-initialized elements, never shrinks
+        void grow_to_at_least(size_type new_size) {
+            std::lock_guard<std::mutex> lock(grow_mutex);
+            size_type first = size.load(std::memory_order_relaxed);
+            if (first < new_size) {
+                Construct(first, new_size - first);
+            }
+        }
+
+    private:
+        template <typename... Args>
+        void Construct(size_type first, size_type count, const Args&... args) {
+            Reserve(first + count);
+            Directory* current = directory.load(std::memory_order_relaxed);
+            size_type constructed = 0;
+            try {
+                for (; constructed < count; constructed++) {
+                    size_type pos = first + constructed;
+                    ::new (static_cast<void*>(current->chunks[pos / N]->list + pos % N)) value_type(args...);
+                }
+            }
+            catch (...) {
+                for (size_type i = 0; i < constructed; i++) {
+                    size_type pos = first + i;
+                    current->chunks[pos / N]->list[pos % N].~value_type();
+                }
+                throw;
+            }
+            size.store(first + count, std::memory_order_release);
+        }
+
+        // allocates chunks up to the given capacity, publishing a bigger directory when needed
+        void Reserve(size_type new_size) {
+            size_type needed = (new_size + N - 1) / N;
+            Directory* current = directory.load(std::memory_order_relaxed);
+            if (needed > current->capacity) {
+                size_type capacity = current->capacity;
+                while (capacity < needed) {
+                    capacity *= 2;
+                }
+                directories.emplace_back(new Directory(capacity));
+                Directory* bigger = directories.back().get();
+                std::copy(current->chunks.get(), current->chunks.get() + chunk_count, bigger->chunks.get());
+                directory.store(bigger, std::memory_order_release);
+                current = bigger;
+            }
+            for (; chunk_count < needed; chunk_count++) {
+                current->chunks[chunk_count] = new Chunk<value_type>(N, allocator);
+            }
+        }
+    };
+}
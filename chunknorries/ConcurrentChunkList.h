@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Append-only ChunkList for many producers. A producer reserves a slot of the tail chunk with one
+    // fetch_add; the producer that finds the tail full links a new chunk with a CAS on next, and the
+    // losers of that race free theirs and move on. Every slot has a state that turns ready once its
+    // element is constructed, so readers walk the published prefix (up to the first slot that is still
+    // being filled) without locks. A slot whose constructor threw is marked failed and skipped.
+    // clear() and the destructor must not run concurrently with anything else.
+    template <typename T, int N, typename Allocator = Allocator<T>>
+    class ConcurrentChunkList {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+
+    private:
+        enum SlotState : unsigned char { SlotEmpty, SlotReady, SlotFailed };
+
+        struct Block {
+            Chunk<value_type> chunk;
+            std::atomic<int> reserved{ 0 }; //slots handed out, can overshoot N while the next block is linked
+            std::atomic<unsigned char> states[N];
+            std::atomic<Block*> next{ nullptr };
+
+            explicit Block(const Allocator& alloc) : chunk(N, alloc) {
+                for (auto& state : states) {
+                    state.store(SlotEmpty, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        Block* start;
+        std::atomic<Block*> tail;
+        std::atomic<size_type> size{ 0 };
+        Allocator allocator;
+
+    public:
+        explicit ConcurrentChunkList(const Allocator& alloc = Allocator()) : allocator(alloc) {
+            start = new Block(allocator);
+            tail.store(start, std::memory_order_relaxed);
+        }
+
+        ConcurrentChunkList(const ConcurrentChunkList& other) = delete;
+
+        ConcurrentChunkList& operator=(const ConcurrentChunkList& other) = delete;
+
+        ~ConcurrentChunkList() {
+            ReleaseBlocks(start);
+        }
+
+        // elements constructed so far, some of them may still lie behind a slot that is being filled
+        size_type get_size() const noexcept {
+            return size.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept {
+            return get_size() == 0;
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            Block* block = tail.load(std::memory_order_acquire);
+            while (true) {
+                if (block->reserved.load(std::memory_order_relaxed) < N) {
+                    int slot = block->reserved.fetch_add(1, std::memory_order_relaxed);
+                    if (slot < N) {
+                        value_type* element = block->chunk.list + slot;
+                        try {
+                            ::new (static_cast<void*>(element)) value_type(std::forward<Args>(args)...);
+                        }
+                        catch (...) {
+                            block->states[slot].store(SlotFailed, std::memory_order_release);
+                            throw;
+                        }
+                        block->states[slot].store(SlotReady, std::memory_order_release);
+                        size.fetch_add(1, std::memory_order_release);
+                        return *element;
+                    }
+                }
+                block = AdvanceTail(block);
+            }
+        }
+
+        // calls f on every element of the published prefix, in list order
+        template <typename Function>
+        void for_each(Function f) const {
+            for_each_chunk([&f](const value_type* values, size_type count) {
+                for (size_type i = 0; i < count; i++) {
+                    f(values[i]);
+                }
+            });
+        }
+
+        // calls f(values, count) for every run of consecutive elements of the published prefix, normally
+        // one run per chunk
+        template <typename Function>
+        void for_each_chunk(Function f) const {
+            for (Block* block = start; block != nullptr; block = block->next.load(std::memory_order_acquire)) {
+                int first = 0;
+                for (int i = 0; i < N; i++) {
+                    unsigned char state = block->states[i].load(std::memory_order_acquire);
+                    if (state == SlotReady) {
+                        continue;
+                    }
+                    if (i > first) {
+                        f(static_cast<const value_type*>(block->chunk.list + first), static_cast<size_type>(i - first));
+                    }
+                    if (state == SlotEmpty) {
+                        return;
+                    }
+                    first = i + 1;
+                }
+                if (first < N) {
+                    f(static_cast<const value_type*>(block->chunk.list + first), static_cast<size_type>(N - first));
+                }
+            }
+        }
+
+        void clear() {
+            Block* fresh = new Block(allocator);
+            ReleaseBlocks(start);
+            start = fresh;
+            tail.store(start, std::memory_order_release);
+            size.store(0, std::memory_order_release);
+        }
+
+    private:
+        // links a new block after a full one unless another producer already did, and moves the tail on
+        Block* AdvanceTail(Block* block) {
+            Block* next = block->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                Block* fresh = new Block(allocator);
+                if (block->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+                    next = fresh;
+                }
+                else {
+                    ReleaseBlock(fresh);
+                }
+            }
+            tail.compare_exchange_strong(block, next, std::memory_order_acq_rel);
+            return next;
+        }
+
+        void ReleaseBlocks(Block* block) noexcept {
+            while (block != nullptr) {
+                Block* next = block->next.load(std::memory_order_relaxed);
+                ReleaseBlock(block);
+                block = next;
+            }
+        }
+
+        void ReleaseBlock(Block* block) noexcept {
+            for (int i = 0; i < N; i++) {
+                if (block->states[i].load(std::memory_order_relaxed) == SlotReady) {
+                    block->chunk.list[i].~value_type();
+                }
+            }
+            block->chunk.allocator.deallocate(block->chunk.list, block->chunk.size);
+            delete block;
+        }
+    };
+}
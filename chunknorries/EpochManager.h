@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace chucknorries {
+    // Epoch-based reclamation for many readers and one writer. A reader pins the current epoch in a
+    // slot for as long as it holds a Guard; the writer unlinks an object first and then retires it,
+    // which tags it with the current epoch and advances the epoch. A retired object is deleted once
+    // every pinned reader has pinned a later epoch, since such a reader started after the unlink.
+    // retire and reclaim must only be called by the writer.
+    class EpochManager {
+    public:
+        using size_type = std::size_t;
+
+        class Guard {
+        private:
+            std::atomic<std::uint64_t>* slot = nullptr;
+
+        public:
+            Guard() noexcept = default;
+
+            explicit Guard(std::atomic<std::uint64_t>* pinned_slot) noexcept : slot(pinned_slot) {}
+
+            Guard(const Guard& other) = delete;
+
+            Guard& operator=(const Guard& other) = delete;
+
+            Guard(Guard&& other) noexcept : slot(other.slot) {
+                other.slot = nullptr;
+            }
+
+            Guard& operator=(Guard&& other) noexcept {
+                if (this != &other) {
+                    unpin();
+                    slot = other.slot;
+                    other.slot = nullptr;
+                }
+                return *this;
+            }
+
+            ~Guard() {
+                unpin();
+            }
+
+            void unpin() noexcept {
+                if (slot != nullptr) {
+                    slot->store(Unpinned, std::memory_order_release);
+                    slot = nullptr;
+                }
+            }
+        };
+
+    private:
+        static constexpr std::uint64_t Unpinned = 0; //a pinned slot holds its epoch + 1
+
+        struct alignas(64) Slot {
+            std::atomic<std::uint64_t> value{ Unpinned };
+        };
+
+        struct Retired {
+            std::uint64_t epoch;
+            std::function<void()> release;
+        };
+
+        std::atomic<std::uint64_t> epoch{ 0 };
+        size_type slot_count;
+        std::unique_ptr<unsigned char[]> slot_storage; //one Slot more than needed, so the slots can start on a cache line
+        Slot* slots = nullptr; //trivially destructible, nothing to destroy
+        std::vector<Retired> retired; //writer only, in epoch order
+
+    public:
+        // new Slot[] only guarantees malloc alignment before C++17, so the slots are aligned by hand
+        explicit EpochManager(size_type reader_slots = 128)
+            : slot_count(reader_slots), slot_storage(new unsigned char[(reader_slots + 1) * sizeof(Slot)]) {
+            void* first = slot_storage.get();
+            size_type space = (reader_slots + 1) * sizeof(Slot);
+            slots = static_cast<Slot*>(std::align(alignof(Slot), reader_slots * sizeof(Slot), first, space));
+            for (size_type i = 0; i < reader_slots; i++) {
+                ::new (static_cast<void*>(slots + i)) Slot();
+            }
+        }
+
+        EpochManager(const EpochManager& other) = delete;
+
+        EpochManager& operator=(const EpochManager& other) = delete;
+
+        // releases everything that is still retired, no reader may be pinned any more
+        ~EpochManager() {
+            for (auto& item : retired) {
+                item.release();
+            }
+        }
+
+        // objects loaded after pin stay alive until the guard is gone
+        Guard pin() {
+            size_type first = std::hash<std::thread::id>()(std::this_thread::get_id()) % slot_count;
+            for (size_type i = 0; i < slot_count; i++) {
+                std::atomic<std::uint64_t>& slot = slots[(first + i) % slot_count].value;
+                std::uint64_t expected = Unpinned;
+                if (slot.load(std::memory_order_relaxed) == Unpinned &&
+                    slot.compare_exchange_strong(expected, epoch.load(std::memory_order_seq_cst) + 1, std::memory_order_seq_cst)) {
+                    return Guard(&slot);
+                }
+            }
+            throw std::runtime_error("EpochManager has no free reader slot!");
+        }
+
+        // hands an unlinked object over, release() runs once no reader can still see it
+        template <typename Release>
+        void retire(Release release) {
+            retired.push_back(Retired{ epoch.fetch_add(1, std::memory_order_seq_cst), std::move(release) });
+            reclaim();
+        }
+
+        // releases the retired objects that no pinned reader can reach
+        void reclaim() {
+            std::uint64_t oldest = epoch.load(std::memory_order_seq_cst) + 1;
+            for (size_type i = 0; i < slot_count; i++) {
+                std::uint64_t pinned = slots[i].value.load(std::memory_order_seq_cst);
+                if (pinned != Unpinned && pinned < oldest) {
+                    oldest = pinned;
+                }
+            }
+            // oldest is the epoch of the oldest reader + 1, objects retired before that epoch are unreachable
+            size_type released = 0;
+            while (released < retired.size() && retired[released].epoch + 1 < oldest) {
+                retired[released].release();
+                released++;
+            }
+            retired.erase(retired.begin(), retired.begin() + released);
+        }
+
+        // retired objects waiting for readers, for tests and tuning
+        size_type get_retired_count() const noexcept {
+            return retired.size();
+        }
+    };
+}
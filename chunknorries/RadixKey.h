@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace chucknorries {
+    // Maps an arithmetic key to an unsigned integer with the same ordering, so that
+    // an LSD radix sort can look at it one byte at a time.
+    template <typename Key, typename = void>
+    struct RadixKey;
+
+    template <typename Key>
+    struct RadixKey<Key, typename std::enable_if<std::is_integral<Key>::value && std::is_unsigned<Key>::value>::type> {
+        using type = Key;
+
+        static type Get(Key key) noexcept {
+            return key;
+        }
+    };
+
+    template <typename Key>
+    struct RadixKey<Key, typename std::enable_if<std::is_integral<Key>::value && std::is_signed<Key>::value>::type> {
+        using type = typename std::make_unsigned<Key>::type;
+
+        static type Get(Key key) noexcept {
+            return static_cast<type>(key) ^ (type(1) << (sizeof(type) * 8 - 1));
+        }
+    };
+
+    template <typename Key>
+    struct RadixKey<Key, typename std::enable_if<std::is_floating_point<Key>::value>::type> {
+        static_assert(sizeof(Key) == 4 || sizeof(Key) == 8, "only float and double keys are supported");
+
+        using type = typename std::conditional<sizeof(Key) == 4, std::uint32_t, std::uint64_t>::type;
+
+        // negative numbers have all bits flipped, positive ones only the sign bit
+        static type Get(Key key) noexcept {
+            type bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            type sign = type(1) << (sizeof(type) * 8 - 1);
+            return (bits & sign) ? ~bits : (bits | sign);
+        }
+    };
+
+    struct RadixIdentity {
+        template <typename T>
+        const T& operator()(const T& value) const noexcept {
+            return value;
+        }
+    };
+}
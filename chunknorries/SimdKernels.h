@@ -0,0 +1,545 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// x86 kernels are compiled per function with target attributes, so no global -m flags are needed;
+// other compilers and architectures only get the scalar kernels
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHUNKNORRIES_X86_SIMD 1
+#define CHUNKNORRIES_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace chucknorries {
+    enum class SimdLevel {
+        Scalar,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    inline const char* GetSimdLevelName(SimdLevel level) noexcept {
+        switch (level) {
+            case SimdLevel::SSE2:
+                return "SSE2";
+            case SimdLevel::AVX2:
+                return "AVX2";
+            case SimdLevel::AVX512:
+                return "AVX-512";
+            default:
+                return "scalar";
+        }
+    }
+
+    // widest instruction set supported by both the CPU and the OS, queried through cpuid
+    inline SimdLevel DetectSimdLevel() noexcept {
+#ifdef CHUNKNORRIES_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SimdLevel::SSE2;
+        }
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    template <typename T>
+    struct ScalarKernels {
+        static T Sum(const T* data, std::size_t count) noexcept {
+            T sum = T();
+            for (std::size_t i = 0; i < count; i++) {
+                sum += data[i];
+            }
+            return sum;
+        }
+
+        // Min and Max skip NaN elements and only return NaN when every element is NaN. Smaller and
+        // Larger define that rule for two values; the vector kernels and ChunkList follow it as well.
+        static T Smaller(const T& a, const T& b) noexcept {
+            return b < a || IsNaN(a, std::is_floating_point<T>()) ? b : a;
+        }
+
+        static T Larger(const T& a, const T& b) noexcept {
+            return a < b || IsNaN(a, std::is_floating_point<T>()) ? b : a;
+        }
+
+        // count has to be positive for Min and Max
+        static T Min(const T* data, std::size_t count) noexcept {
+            T result = data[0];
+            for (std::size_t i = 1; i < count; i++) {
+                result = Smaller(result, data[i]);
+            }
+            return result;
+        }
+
+        static T Max(const T* data, std::size_t count) noexcept {
+            T result = data[0];
+            for (std::size_t i = 1; i < count; i++) {
+                result = Larger(result, data[i]);
+            }
+            return result;
+        }
+
+        static std::size_t CountEqual(const T* data, std::size_t count, T value) noexcept {
+            std::size_t result = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                result += data[i] == value;
+            }
+            return result;
+        }
+
+        // index of the first element equal to value, or count
+        static std::size_t FindFirst(const T* data, std::size_t count, T value) noexcept {
+            for (std::size_t i = 0; i < count; i++) {
+                if (data[i] == value) {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        static bool AnyGreater(const T* data, std::size_t count, T value) noexcept {
+            for (std::size_t i = 0; i < count; i++) {
+                if (value < data[i]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        // NaN is the only value that is not equal to itself
+        static bool IsNaN(const T& value, std::true_type) noexcept {
+            return value != value;
+        }
+
+        static bool IsNaN(const T&, std::false_type) noexcept {
+            return false;
+        }
+    };
+
+#ifdef CHUNKNORRIES_X86_SIMD
+    // Per instruction set and element type: a vector type V holding Width elements and the handful
+    // of operations the kernels need. EqualMask and GreaterMask return one bit per lane.
+    // Min(a, b) and Max(a, b) fold the elements b into the accumulator a by the NaN rule of
+    // ScalarKernels::Smaller and Larger. The min/max instructions return their second operand when
+    // either one is NaN, so they get b first, which skips a NaN in b, and a NaN lane of a takes b.
+    template <typename T>
+    struct Sse2Ops;
+
+    template <>
+    struct Sse2Ops<std::int32_t> {
+        using value_type = std::int32_t;
+        using V = __m128i;
+        static constexpr int Width = 4;
+
+        CHUNKNORRIES_TARGET("sse2") static V Load(const value_type* data) { return _mm_loadu_si128(reinterpret_cast<const V*>(data)); }
+        CHUNKNORRIES_TARGET("sse2") static void Store(value_type* data, V v) { _mm_storeu_si128(reinterpret_cast<V*>(data), v); }
+        CHUNKNORRIES_TARGET("sse2") static V Set(value_type value) { return _mm_set1_epi32(value); }
+        CHUNKNORRIES_TARGET("sse2") static V Add(V a, V b) { return _mm_add_epi32(a, b); }
+        CHUNKNORRIES_TARGET("sse2") static V Min(V a, V b) { V greater = _mm_cmpgt_epi32(a, b); return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a)); }
+        CHUNKNORRIES_TARGET("sse2") static V Max(V a, V b) { V greater = _mm_cmpgt_epi32(a, b); return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b)); }
+        CHUNKNORRIES_TARGET("sse2") static unsigned EqualMask(V a, V b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+        CHUNKNORRIES_TARGET("sse2") static unsigned GreaterMask(V a, V b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b))); }
+    };
+
+    template <>
+    struct Sse2Ops<std::int64_t> {
+        using value_type = std::int64_t;
+        using V = __m128i;
+        static constexpr int Width = 2;
+
+        CHUNKNORRIES_TARGET("sse2") static V Load(const value_type* data) { return _mm_loadu_si128(reinterpret_cast<const V*>(data)); }
+        CHUNKNORRIES_TARGET("sse2") static void Store(value_type* data, V v) { _mm_storeu_si128(reinterpret_cast<V*>(data), v); }
+        CHUNKNORRIES_TARGET("sse2") static V Set(value_type value) { return _mm_set1_epi64x(value); }
+        CHUNKNORRIES_TARGET("sse2") static V Add(V a, V b) { return _mm_add_epi64(a, b); }
+        CHUNKNORRIES_TARGET("sse2") static V Min(V a, V b) { V greater = Greater(a, b); return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a)); }
+        CHUNKNORRIES_TARGET("sse2") static V Max(V a, V b) { V greater = Greater(a, b); return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b)); }
+
+        CHUNKNORRIES_TARGET("sse2") static unsigned EqualMask(V a, V b) {
+            V equal = _mm_cmpeq_epi32(a, b);
+            equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_movemask_pd(_mm_castsi128_pd(equal));
+        }
+
+        CHUNKNORRIES_TARGET("sse2") static unsigned GreaterMask(V a, V b) { return _mm_movemask_pd(_mm_castsi128_pd(Greater(a, b))); }
+
+        // SSE2 has no 64-bit compare: signed compare of the high halves, unsigned compare of the low ones
+        CHUNKNORRIES_TARGET("sse2") static V Greater(V a, V b) {
+            V low_sign = _mm_set_epi32(0, INT32_MIN, 0, INT32_MIN);
+            a = _mm_xor_si128(a, low_sign);
+            b = _mm_xor_si128(b, low_sign);
+            V greater = _mm_cmpgt_epi32(a, b);
+            V equal = _mm_cmpeq_epi32(a, b);
+            V high_greater = _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+            V high_equal = _mm_shuffle_epi32(equal, _MM_SHUFFLE(3, 3, 1, 1));
+            V low_greater = _mm_shuffle_epi32(greater, _MM_SHUFFLE(2, 2, 0, 0));
+            return _mm_or_si128(high_greater, _mm_and_si128(high_equal, low_greater));
+        }
+    };
+
+    template <>
+    struct Sse2Ops<float> {
+        using value_type = float;
+        using V = __m128;
+        static constexpr int Width = 4;
+
+        CHUNKNORRIES_TARGET("sse2") static V Load(const value_type* data) { return _mm_loadu_ps(data); }
+        CHUNKNORRIES_TARGET("sse2") static void Store(value_type* data, V v) { _mm_storeu_ps(data, v); }
+        CHUNKNORRIES_TARGET("sse2") static V Set(value_type value) { return _mm_set1_ps(value); }
+        CHUNKNORRIES_TARGET("sse2") static V Add(V a, V b) { return _mm_add_ps(a, b); }
+        CHUNKNORRIES_TARGET("sse2") static V Min(V a, V b) { return TakeWhereNaN(a, b, _mm_min_ps(b, a)); }
+        CHUNKNORRIES_TARGET("sse2") static V Max(V a, V b) { return TakeWhereNaN(a, b, _mm_max_ps(b, a)); }
+        CHUNKNORRIES_TARGET("sse2") static unsigned EqualMask(V a, V b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+        CHUNKNORRIES_TARGET("sse2") static unsigned GreaterMask(V a, V b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+
+        // b in the lanes where a is NaN, result elsewhere
+        CHUNKNORRIES_TARGET("sse2") static V TakeWhereNaN(V a, V b, V result) {
+            V nan = _mm_cmpunord_ps(a, a);
+            return _mm_or_ps(_mm_and_ps(nan, b), _mm_andnot_ps(nan, result));
+        }
+    };
+
+    template <>
+    struct Sse2Ops<double> {
+        using value_type = double;
+        using V = __m128d;
+        static constexpr int Width = 2;
+
+        CHUNKNORRIES_TARGET("sse2") static V Load(const value_type* data) { return _mm_loadu_pd(data); }
+        CHUNKNORRIES_TARGET("sse2") static void Store(value_type* data, V v) { _mm_storeu_pd(data, v); }
+        CHUNKNORRIES_TARGET("sse2") static V Set(value_type value) { return _mm_set1_pd(value); }
+        CHUNKNORRIES_TARGET("sse2") static V Add(V a, V b) { return _mm_add_pd(a, b); }
+        CHUNKNORRIES_TARGET("sse2") static V Min(V a, V b) { return TakeWhereNaN(a, b, _mm_min_pd(b, a)); }
+        CHUNKNORRIES_TARGET("sse2") static V Max(V a, V b) { return TakeWhereNaN(a, b, _mm_max_pd(b, a)); }
+        CHUNKNORRIES_TARGET("sse2") static unsigned EqualMask(V a, V b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+        CHUNKNORRIES_TARGET("sse2") static unsigned GreaterMask(V a, V b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+
+        CHUNKNORRIES_TARGET("sse2") static V TakeWhereNaN(V a, V b, V result) {
+            V nan = _mm_cmpunord_pd(a, a);
+            return _mm_or_pd(_mm_and_pd(nan, b), _mm_andnot_pd(nan, result));
+        }
+    };
+
+    template <typename T>
+    struct Avx2Ops;
+
+    template <>
+    struct Avx2Ops<std::int32_t> {
+        using value_type = std::int32_t;
+        using V = __m256i;
+        static constexpr int Width = 8;
+
+        CHUNKNORRIES_TARGET("avx2") static V Load(const value_type* data) { return _mm256_loadu_si256(reinterpret_cast<const V*>(data)); }
+        CHUNKNORRIES_TARGET("avx2") static void Store(value_type* data, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(data), v); }
+        CHUNKNORRIES_TARGET("avx2") static V Set(value_type value) { return _mm256_set1_epi32(value); }
+        CHUNKNORRIES_TARGET("avx2") static V Add(V a, V b) { return _mm256_add_epi32(a, b); }
+        CHUNKNORRIES_TARGET("avx2") static V Min(V a, V b) { return _mm256_min_epi32(a, b); }
+        CHUNKNORRIES_TARGET("avx2") static V Max(V a, V b) { return _mm256_max_epi32(a, b); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned EqualMask(V a, V b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned GreaterMask(V a, V b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))); }
+    };
+
+    template <>
+    struct Avx2Ops<std::int64_t> {
+        using value_type = std::int64_t;
+        using V = __m256i;
+        static constexpr int Width = 4;
+
+        CHUNKNORRIES_TARGET("avx2") static V Load(const value_type* data) { return _mm256_loadu_si256(reinterpret_cast<const V*>(data)); }
+        CHUNKNORRIES_TARGET("avx2") static void Store(value_type* data, V v) { _mm256_storeu_si256(reinterpret_cast<V*>(data), v); }
+        CHUNKNORRIES_TARGET("avx2") static V Set(value_type value) { return _mm256_set1_epi64x(value); }
+        CHUNKNORRIES_TARGET("avx2") static V Add(V a, V b) { return _mm256_add_epi64(a, b); }
+        CHUNKNORRIES_TARGET("avx2") static V Min(V a, V b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+        CHUNKNORRIES_TARGET("avx2") static V Max(V a, V b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned EqualMask(V a, V b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned GreaterMask(V a, V b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))); }
+    };
+
+    template <>
+    struct Avx2Ops<float> {
+        using value_type = float;
+        using V = __m256;
+        static constexpr int Width = 8;
+
+        CHUNKNORRIES_TARGET("avx2") static V Load(const value_type* data) { return _mm256_loadu_ps(data); }
+        CHUNKNORRIES_TARGET("avx2") static void Store(value_type* data, V v) { _mm256_storeu_ps(data, v); }
+        CHUNKNORRIES_TARGET("avx2") static V Set(value_type value) { return _mm256_set1_ps(value); }
+        CHUNKNORRIES_TARGET("avx2") static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+        CHUNKNORRIES_TARGET("avx2") static V Min(V a, V b) { return _mm256_blendv_ps(_mm256_min_ps(b, a), b, _mm256_cmp_ps(a, a, _CMP_UNORD_Q)); }
+        CHUNKNORRIES_TARGET("avx2") static V Max(V a, V b) { return _mm256_blendv_ps(_mm256_max_ps(b, a), b, _mm256_cmp_ps(a, a, _CMP_UNORD_Q)); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned EqualMask(V a, V b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned GreaterMask(V a, V b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+    };
+
+    template <>
+    struct Avx2Ops<double> {
+        using value_type = double;
+        using V = __m256d;
+        static constexpr int Width = 4;
+
+        CHUNKNORRIES_TARGET("avx2") static V Load(const value_type* data) { return _mm256_loadu_pd(data); }
+        CHUNKNORRIES_TARGET("avx2") static void Store(value_type* data, V v) { _mm256_storeu_pd(data, v); }
+        CHUNKNORRIES_TARGET("avx2") static V Set(value_type value) { return _mm256_set1_pd(value); }
+        CHUNKNORRIES_TARGET("avx2") static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+        CHUNKNORRIES_TARGET("avx2") static V Min(V a, V b) { return _mm256_blendv_pd(_mm256_min_pd(b, a), b, _mm256_cmp_pd(a, a, _CMP_UNORD_Q)); }
+        CHUNKNORRIES_TARGET("avx2") static V Max(V a, V b) { return _mm256_blendv_pd(_mm256_max_pd(b, a), b, _mm256_cmp_pd(a, a, _CMP_UNORD_Q)); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned EqualMask(V a, V b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+        CHUNKNORRIES_TARGET("avx2") static unsigned GreaterMask(V a, V b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+    };
+
+    template <typename T>
+    struct Avx512Ops;
+
+    template <>
+    struct Avx512Ops<std::int32_t> {
+        using value_type = std::int32_t;
+        using V = __m512i;
+        static constexpr int Width = 16;
+
+        CHUNKNORRIES_TARGET("avx512f") static V Load(const value_type* data) { return _mm512_loadu_si512(data); }
+        CHUNKNORRIES_TARGET("avx512f") static void Store(value_type* data, V v) { _mm512_storeu_si512(data, v); }
+        CHUNKNORRIES_TARGET("avx512f") static V Set(value_type value) { return _mm512_set1_epi32(value); }
+        CHUNKNORRIES_TARGET("avx512f") static V Add(V a, V b) { return _mm512_add_epi32(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Min(V a, V b) { return _mm512_min_epi32(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Max(V a, V b) { return _mm512_max_epi32(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned EqualMask(V a, V b) { return _mm512_cmpeq_epi32_mask(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned GreaterMask(V a, V b) { return _mm512_cmpgt_epi32_mask(a, b); }
+    };
+
+    template <>
+    struct Avx512Ops<std::int64_t> {
+        using value_type = std::int64_t;
+        using V = __m512i;
+        static constexpr int Width = 8;
+
+        CHUNKNORRIES_TARGET("avx512f") static V Load(const value_type* data) { return _mm512_loadu_si512(data); }
+        CHUNKNORRIES_TARGET("avx512f") static void Store(value_type* data, V v) { _mm512_storeu_si512(data, v); }
+        CHUNKNORRIES_TARGET("avx512f") static V Set(value_type value) { return _mm512_set1_epi64(value); }
+        CHUNKNORRIES_TARGET("avx512f") static V Add(V a, V b) { return _mm512_add_epi64(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Min(V a, V b) { return _mm512_min_epi64(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Max(V a, V b) { return _mm512_max_epi64(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned EqualMask(V a, V b) { return _mm512_cmpeq_epi64_mask(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned GreaterMask(V a, V b) { return _mm512_cmpgt_epi64_mask(a, b); }
+    };
+
+    template <>
+    struct Avx512Ops<float> {
+        using value_type = float;
+        using V = __m512;
+        static constexpr int Width = 16;
+
+        CHUNKNORRIES_TARGET("avx512f") static V Load(const value_type* data) { return _mm512_loadu_ps(data); }
+        CHUNKNORRIES_TARGET("avx512f") static void Store(value_type* data, V v) { _mm512_storeu_ps(data, v); }
+        CHUNKNORRIES_TARGET("avx512f") static V Set(value_type value) { return _mm512_set1_ps(value); }
+        CHUNKNORRIES_TARGET("avx512f") static V Add(V a, V b) { return _mm512_add_ps(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Min(V a, V b) { return _mm512_mask_mov_ps(_mm512_min_ps(b, a), _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q), b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Max(V a, V b) { return _mm512_mask_mov_ps(_mm512_max_ps(b, a), _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q), b); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned EqualMask(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned GreaterMask(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    };
+
+    template <>
+    struct Avx512Ops<double> {
+        using value_type = double;
+        using V = __m512d;
+        static constexpr int Width = 8;
+
+        CHUNKNORRIES_TARGET("avx512f") static V Load(const value_type* data) { return _mm512_loadu_pd(data); }
+        CHUNKNORRIES_TARGET("avx512f") static void Store(value_type* data, V v) { _mm512_storeu_pd(data, v); }
+        CHUNKNORRIES_TARGET("avx512f") static V Set(value_type value) { return _mm512_set1_pd(value); }
+        CHUNKNORRIES_TARGET("avx512f") static V Add(V a, V b) { return _mm512_add_pd(a, b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Min(V a, V b) { return _mm512_mask_mov_pd(_mm512_min_pd(b, a), _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q), b); }
+        CHUNKNORRIES_TARGET("avx512f") static V Max(V a, V b) { return _mm512_mask_mov_pd(_mm512_max_pd(b, a), _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q), b); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned EqualMask(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+        CHUNKNORRIES_TARGET("avx512f") static unsigned GreaterMask(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    };
+
+    // The kernels are written once and stamped out per instruction set, since every function
+    // that inlines the intrinsics has to carry the matching target attribute.
+#define CHUNKNORRIES_VECTOR_KERNELS(Name, isa)                                                        \
+    template <typename T, typename Ops>                                                               \
+    struct Name {                                                                                     \
+        using U = typename Ops::value_type;                                                           \
+        using V = typename Ops::V;                                                                    \
+        static constexpr std::size_t W = Ops::Width;                                                  \
+                                                                                                      \
+        /* T is U or another integer type of the same size and signedness */                          \
+        CHUNKNORRIES_TARGET(isa) static V Load(const T* data) {                                       \
+            return Ops::Load(reinterpret_cast<const U*>(data));                                       \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static void Store(T* data, V v) {                                    \
+            Ops::Store(reinterpret_cast<U*>(data), v);                                                \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static T Sum(const T* data, std::size_t count) {                     \
+            V sum = Ops::Set(U());                                                                    \
+            std::size_t i = 0;                                                                        \
+            for (; i + W <= count; i += W) {                                                          \
+                sum = Ops::Add(sum, Load(data + i));                                                  \
+            }                                                                                         \
+            T lanes[W];                                                                               \
+            Store(lanes, sum);                                                                        \
+            return ScalarKernels<T>::Sum(lanes, W) + ScalarKernels<T>::Sum(data + i, count - i);      \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static T Min(const T* data, std::size_t count) {                     \
+            if (count < W) {                                                                          \
+                return ScalarKernels<T>::Min(data, count);                                            \
+            }                                                                                         \
+            V result = Load(data);                                                                    \
+            std::size_t i = W;                                                                        \
+            for (; i + W <= count; i += W) {                                                          \
+                result = Ops::Min(result, Load(data + i));                                            \
+            }                                                                                         \
+            T lanes[W];                                                                               \
+            Store(lanes, Ops::Min(result, Load(data + count - W)));                                   \
+            return ScalarKernels<T>::Min(lanes, W);                                                   \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static T Max(const T* data, std::size_t count) {                     \
+            if (count < W) {                                                                          \
+                return ScalarKernels<T>::Max(data, count);                                            \
+            }                                                                                         \
+            V result = Load(data);                                                                    \
+            std::size_t i = W;                                                                        \
+            for (; i + W <= count; i += W) {                                                          \
+                result = Ops::Max(result, Load(data + i));                                            \
+            }                                                                                         \
+            T lanes[W];                                                                               \
+            Store(lanes, Ops::Max(result, Load(data + count - W)));                                   \
+            return ScalarKernels<T>::Max(lanes, W);                                                   \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static std::size_t CountEqual(const T* data, std::size_t count, T value) { \
+            V needle = Ops::Set(static_cast<U>(value));                                               \
+            std::size_t result = 0;                                                                   \
+            std::size_t i = 0;                                                                        \
+            for (; i + W <= count; i += W) {                                                          \
+                result += __builtin_popcount(Ops::EqualMask(Load(data + i), needle));                 \
+            }                                                                                         \
+            return result + ScalarKernels<T>::CountEqual(data + i, count - i, value);                 \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static std::size_t FindFirst(const T* data, std::size_t count, T value) { \
+            V needle = Ops::Set(static_cast<U>(value));                                               \
+            std::size_t i = 0;                                                                        \
+            for (; i + W <= count; i += W) {                                                          \
+                unsigned mask = Ops::EqualMask(Load(data + i), needle);                               \
+                if (mask != 0) {                                                                      \
+                    return i + __builtin_ctz(mask);                                                   \
+                }                                                                                     \
+            }                                                                                         \
+            return i + ScalarKernels<T>::FindFirst(data + i, count - i, value);                       \
+        }                                                                                             \
+                                                                                                      \
+        CHUNKNORRIES_TARGET(isa) static bool AnyGreater(const T* data, std::size_t count, T value) {  \
+            V threshold = Ops::Set(static_cast<U>(value));                                            \
+            std::size_t i = 0;                                                                        \
+            for (; i + W <= count; i += W) {                                                          \
+                if (Ops::GreaterMask(Load(data + i), threshold) != 0) {                               \
+                    return true;                                                                      \
+                }                                                                                     \
+            }                                                                                         \
+            return ScalarKernels<T>::AnyGreater(data + i, count - i, value);                          \
+        }                                                                                             \
+    };
+
+    CHUNKNORRIES_VECTOR_KERNELS(Sse2Kernels, "sse2")
+    CHUNKNORRIES_VECTOR_KERNELS(Avx2Kernels, "avx2")
+    CHUNKNORRIES_VECTOR_KERNELS(Avx512Kernels, "avx512f")
+
+#undef CHUNKNORRIES_VECTOR_KERNELS
+#endif
+
+    // element type whose vector ops serve T, void when there are none. Integers are matched by size
+    // and signedness, so long long gets the int64_t kernels also where int64_t is long.
+    template <typename T, typename = void>
+    struct SimdKernelType {
+        using type = void;
+    };
+
+    template <typename T>
+    struct SimdKernelType<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                                     (sizeof(T) == 4 || sizeof(T) == 8)>::type> {
+        using type = typename std::conditional<sizeof(T) == 4, std::int32_t, std::int64_t>::type;
+    };
+
+    template <typename T>
+    struct SimdKernelType<T, typename std::enable_if<std::is_same<T, float>::value || std::is_same<T, double>::value>::type> {
+        using type = T;
+    };
+
+    template <typename T>
+    struct HasSimdKernels : std::integral_constant<bool, !std::is_void<typename SimdKernelType<T>::type>::value> {};
+
+    template <typename T>
+    struct SimdKernelTable {
+        SimdLevel level = SimdLevel::Scalar;
+        T (*sum)(const T*, std::size_t) = &ScalarKernels<T>::Sum;
+        T (*min)(const T*, std::size_t) = &ScalarKernels<T>::Min;
+        T (*max)(const T*, std::size_t) = &ScalarKernels<T>::Max;
+        std::size_t (*count_equal)(const T*, std::size_t, T) = &ScalarKernels<T>::CountEqual;
+        std::size_t (*find_first)(const T*, std::size_t, T) = &ScalarKernels<T>::FindFirst;
+        bool (*any_greater)(const T*, std::size_t, T) = &ScalarKernels<T>::AnyGreater;
+    };
+
+    template <typename T, typename Kernels>
+    void FillKernelTable(SimdKernelTable<T>& table, SimdLevel level) noexcept {
+        table.level = level;
+        table.sum = &Kernels::Sum;
+        table.min = &Kernels::Min;
+        table.max = &Kernels::Max;
+        table.count_equal = &Kernels::CountEqual;
+        table.find_first = &Kernels::FindFirst;
+        table.any_greater = &Kernels::AnyGreater;
+    }
+
+    template <typename T>
+    SimdKernelTable<T> MakeKernelTable(SimdLevel, std::false_type) noexcept {
+        return SimdKernelTable<T>();
+    }
+
+    template <typename T>
+    SimdKernelTable<T> MakeKernelTable(SimdLevel level, std::true_type) noexcept {
+        SimdKernelTable<T> table;
+#ifdef CHUNKNORRIES_X86_SIMD
+        using U = typename SimdKernelType<T>::type;
+        switch (level) {
+            case SimdLevel::AVX512:
+                FillKernelTable<T, Avx512Kernels<T, Avx512Ops<U>>>(table, level);
+                break;
+            case SimdLevel::AVX2:
+                FillKernelTable<T, Avx2Kernels<T, Avx2Ops<U>>>(table, level);
+                break;
+            case SimdLevel::SSE2:
+                FillKernelTable<T, Sse2Kernels<T, Sse2Ops<U>>>(table, level);
+                break;
+            default:
+                break;
+        }
+#endif
+        return table;
+    }
+
+    // kernels for an explicit level, which must not be above DetectSimdLevel();
+    // element types without vector kernels always get the scalar ones
+    template <typename T>
+    SimdKernelTable<T> MakeKernelTable(SimdLevel level) noexcept {
+        return MakeKernelTable<T>(level, HasSimdKernels<T>());
+    }
+
+    // kernels for the widest level of this CPU, selected once
+    template <typename T>
+    const SimdKernelTable<T>& GetSimdKernels() noexcept {
+        static const SimdKernelTable<T> table = MakeKernelTable<T>(DetectSimdLevel());
+        return table;
+    }
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "Chunk.h"
+#include "EpochManager.h"
+
+namespace chucknorries {
+    // List for one writer and many readers, where every reader iterates a consistent snapshot without
+    // blocking the writer. The chunks are listed in an immutable directory that the writer publishes
+    // atomically. Appends construct the element in place behind every existing snapshot and then raise
+    // the size of the current directory. erase copies the affected chunk and the directory, publishes
+    // them, and retires the old ones to an EpochManager, which frees them once no snapshot can see them.
+    // push_back, emplace_back and erase must only be called by the writer.
+    template <typename T, int N, typename Allocator = Allocator<T>>
+    class SnapshotChunkList {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using const_reference = const value_type&;
+
+    private:
+        struct Entry {
+            Chunk<value_type>* chunk;
+            int count; //elements of the chunk, N for the last chunk whose fill is bounded by the size
+        };
+
+        struct Directory {
+            std::unique_ptr<Entry[]> entries;
+            size_type capacity;
+            size_type chunk_count = 0; //writer only
+            std::atomic<size_type> size{ 0 };
+
+            explicit Directory(size_type entry_capacity) : entries(new Entry[entry_capacity]), capacity(entry_capacity) {}
+        };
+
+    public:
+        // the list as it was when snapshot() was called; keeps the chunks it sees alive
+        class Snapshot {
+        private:
+            EpochManager::Guard guard;
+            const Directory* directory;
+            size_type size;
+
+        public:
+            Snapshot(EpochManager::Guard&& pinned, const Directory* current) noexcept
+                : guard(std::move(pinned)), directory(current), size(current->size.load(std::memory_order_acquire)) {}
+
+            size_type get_size() const noexcept {
+                return size;
+            }
+
+            bool empty() const noexcept {
+                return size == 0;
+            }
+
+            // calls f(values, count) for every chunk, in list order
+            template <typename Function>
+            void for_each_chunk(Function f) const {
+                size_type remaining = size;
+                for (size_type i = 0; remaining > 0; i++) {
+                    size_type count = std::min<size_type>(directory->entries[i].count, remaining);
+                    f(static_cast<const value_type*>(directory->entries[i].chunk->list), count);
+                    remaining -= count;
+                }
+            }
+
+            template <typename Function>
+            void for_each(Function f) const {
+                for_each_chunk([&f](const value_type* values, size_type count) {
+                    for (size_type i = 0; i < count; i++) {
+                        f(values[i]);
+                    }
+                });
+            }
+        };
+
+    private:
+        std::atomic<Directory*> directory;
+        int tail_count = 0; //elements in the last chunk, writer only
+        Allocator allocator;
+        mutable EpochManager epochs;
+
+    public:
+        explicit SnapshotChunkList(const Allocator& alloc = Allocator(), size_type reader_slots = 128)
+            : directory(new Directory(8)), allocator(alloc), epochs(reader_slots) {}
+
+        SnapshotChunkList(const SnapshotChunkList& other) = delete;
+
+        SnapshotChunkList& operator=(const SnapshotChunkList& other) = delete;
+
+        ~SnapshotChunkList() {
+            Directory* current = directory.load(std::memory_order_relaxed);
+            for (size_type i = 0; i < current->chunk_count; i++) {
+                ReleaseChunk(current->entries[i].chunk);
+            }
+            delete current;
+        }
+
+        Snapshot snapshot() const {
+            EpochManager::Guard guard = epochs.pin();
+            return Snapshot(std::move(guard), directory.load(std::memory_order_seq_cst));
+        }
+
+        size_type get_size() const noexcept {
+            return directory.load(std::memory_order_acquire)->size.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept {
+            return get_size() == 0;
+        }
+
+        // objects waiting for readers to move on, for tests and tuning
+        size_type get_retired_count() const noexcept {
+            return epochs.get_retired_count();
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        void emplace_back(Args&&... args) {
+            Directory* current = directory.load(std::memory_order_relaxed);
+            if (current->chunk_count == 0 || tail_count == N) {
+                // a new entry lies behind every snapshot, so it is written in place unless the directory is full
+                Directory* target = current->chunk_count == current->capacity ? CopyDirectory(current, current->capacity * 2) : current;
+                try {
+                    target->entries[target->chunk_count] = Entry{ new Chunk<value_type>(N, allocator), N };
+                }
+                catch (...) {
+                    if (target != current) {
+                        delete target;
+                    }
+                    throw;
+                }
+                target->chunk_count++;
+                tail_count = 0;
+                if (target != current) {
+                    Publish(current, target);
+                    current = target;
+                }
+            }
+            Chunk<value_type>* tail = current->entries[current->chunk_count - 1].chunk;
+            ::new (static_cast<void*>(tail->list + tail_count)) value_type(std::forward<Args>(args)...);
+            tail->current_size = ++tail_count;
+            current->size.store(current->size.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // snapshots taken before keep seeing the element
+        void erase(size_type pos) {
+            Directory* current = directory.load(std::memory_order_relaxed);
+            size_type size = current->size.load(std::memory_order_relaxed);
+            if (pos >= size) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            size_type chunk_index = 0;
+            while (pos >= static_cast<size_type>(current->entries[chunk_index].count)) {
+                pos -= current->entries[chunk_index].count;
+                chunk_index++;
+            }
+            bool is_tail = chunk_index + 1 == current->chunk_count;
+            Chunk<value_type>* old_chunk = current->entries[chunk_index].chunk;
+            int old_count = is_tail ? tail_count : current->entries[chunk_index].count;
+
+            Directory* updated = CopyDirectory(current, current->capacity);
+            if (old_count == 1) {
+                std::copy(updated->entries.get() + chunk_index + 1, updated->entries.get() + updated->chunk_count,
+                          updated->entries.get() + chunk_index);
+                updated->chunk_count--;
+            }
+            else {
+                Chunk<value_type>* copy = nullptr;
+                try {
+                    copy = new Chunk<value_type>(N, allocator);
+                    for (int i = 0; i < old_count; i++) {
+                        if (i != static_cast<int>(pos)) {
+                            ::new (static_cast<void*>(copy->list + copy->current_size)) value_type(old_chunk->list[i]);
+                            copy->current_size++;
+                        }
+                    }
+                }
+                catch (...) {
+                    if (copy != nullptr) {
+                        ReleaseChunk(copy);
+                    }
+                    delete updated;
+                    throw;
+                }
+                updated->entries[chunk_index] = Entry{ copy, is_tail ? N : old_count - 1 };
+            }
+            updated->size.store(size - 1, std::memory_order_relaxed);
+            if (is_tail && old_count > 1) {
+                tail_count = old_count - 1;
+            }
+            else if (is_tail && updated->chunk_count > 0) {
+                // appends continue in the chunk before, which may not be full
+                Entry& last = updated->entries[updated->chunk_count - 1];
+                tail_count = last.count;
+                last.count = N;
+            }
+            Publish(current, updated);
+            epochs.retire([this, old_chunk] {
+                ReleaseChunk(old_chunk);
+            });
+        }
+
+        // frees what earlier erases retired once the readers have moved on, erase does this as well
+        void reclaim() {
+            epochs.reclaim();
+        }
+
+    private:
+        Directory* CopyDirectory(const Directory* current, size_type capacity) {
+            Directory* copy = new Directory(capacity);
+            std::copy(current->entries.get(), current->entries.get() + current->chunk_count, copy->entries.get());
+            copy->chunk_count = current->chunk_count;
+            copy->size.store(current->size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return copy;
+        }
+
+        void Publish(Directory* old_directory, Directory* new_directory) {
+            directory.store(new_directory, std::memory_order_seq_cst);
+            epochs.retire([old_directory] {
+                delete old_directory;
+            });
+        }
+
+        void ReleaseChunk(Chunk<value_type>* chunk) noexcept {
+            for (int i = 0; i < chunk->current_size; i++) {
+                chunk->list[i].~value_type();
+            }
+            chunk->allocator.deallocate(chunk->list, chunk->size);
+            delete chunk;
+        }
+    };
+}
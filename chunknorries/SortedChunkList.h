@@ -0,0 +1,331 @@
+#pragma once
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Ordered list of chunks that are only partially filled. The first key of every chunk is kept in
+    // a fence array, so a lookup is a binary search over the fences followed by one inside a chunk.
+    // A full chunk is split in halves on insert, a chunk that drops below a quarter is merged into
+    // a neighbour on erase. Equal keys keep their insertion order.
+    template <typename T, int N, typename Compare = std::less<T>, typename Allocator = Allocator<T>>
+    class SortedChunkList {
+        static_assert(N >= 2, "chunks have to hold at least two elements to be split");
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using const_reference = const value_type&;
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+        private:
+            const SortedChunkList* owner = nullptr;
+            size_type chunk_index = 0;
+            int slot = 0;
+
+            friend class SortedChunkList;
+
+        public:
+            const_iterator() noexcept = default;
+
+            const_iterator(const SortedChunkList* list, size_type chunk, int chunk_slot) noexcept
+                : owner(list), chunk_index(chunk), slot(chunk_slot) {}
+
+            reference operator*() const {
+                return owner->chunks[chunk_index]->list[slot];
+            }
+
+            pointer operator->() const {
+                return owner->chunks[chunk_index]->list + slot;
+            }
+
+            const_iterator& operator++() {
+                if (++slot == owner->chunks[chunk_index]->current_size) {
+                    chunk_index++;
+                    slot = 0;
+                }
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            friend bool operator==(const const_iterator& first, const const_iterator& second) noexcept {
+                return first.chunk_index == second.chunk_index && first.slot == second.slot;
+            }
+
+            friend bool operator!=(const const_iterator& first, const const_iterator& second) noexcept {
+                return !(first == second);
+            }
+        };
+
+    private:
+        int size = 0;
+        std::vector<Chunk<value_type>*> chunks;
+        std::vector<value_type> fences; //fences[i] is the first key of chunks[i]
+        Compare comp;
+        Allocator allocator;
+
+    public:
+        explicit SortedChunkList(const Compare& compare = Compare(), const Allocator& alloc = Allocator())
+            : comp(compare), allocator(alloc) {}
+
+        SortedChunkList(const SortedChunkList& other) = delete;
+
+        SortedChunkList& operator=(const SortedChunkList& other) = delete;
+
+        ~SortedChunkList() {
+            clear();
+        }
+
+        int get_size() const noexcept {
+            return size;
+        }
+
+        bool empty() const noexcept {
+            return size == 0;
+        }
+
+        // number of chunks in use, for tests and tuning
+        size_type get_chunk_count() const noexcept {
+            return chunks.size();
+        }
+
+        const_reference front() const {
+            if (size == 0) {
+                throw std::runtime_error("SortedChunkList is empty!");
+            }
+            return chunks.front()->list[0];
+        }
+
+        const_reference back() const {
+            if (size == 0) {
+                throw std::runtime_error("SortedChunkList is empty!");
+            }
+            return chunks.back()->list[chunks.back()->current_size - 1];
+        }
+
+        const_iterator begin() const noexcept {
+            return const_iterator(this, 0, 0);
+        }
+
+        const_iterator end() const noexcept {
+            return const_iterator(this, chunks.size(), 0);
+        }
+
+        // first element that is not less than key
+        const_iterator lower_bound(const T& key) const {
+            if (size == 0) {
+                return end();
+            }
+            size_type chunk_index = FindChunk(key, false);
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            int slot = std::lower_bound(chunk->list, chunk->list + chunk->current_size, key, comp) - chunk->list;
+            return Normalize(chunk_index, slot);
+        }
+
+        // first element that is greater than key
+        const_iterator upper_bound(const T& key) const {
+            if (size == 0) {
+                return end();
+            }
+            size_type chunk_index = FindChunk(key, true);
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            int slot = std::upper_bound(chunk->list, chunk->list + chunk->current_size, key, comp) - chunk->list;
+            return Normalize(chunk_index, slot);
+        }
+
+        const_iterator find(const T& key) const {
+            const_iterator found = lower_bound(key);
+            if (found == end() || comp(key, *found)) {
+                return end();
+            }
+            return found;
+        }
+
+        bool contains(const T& key) const {
+            return find(key) != end();
+        }
+
+        size_type count(const T& key) const {
+            size_type result = 0;
+            for (const_iterator it = lower_bound(key); it != end() && !comp(key, *it); ++it) {
+                result++;
+            }
+            return result;
+        }
+
+        // inserts after all elements equal to value
+        const_iterator insert(const T& value) {
+            if (chunks.empty()) {
+                AddChunk(0, value);
+            }
+            size_type chunk_index = FindChunk(value, true);
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            int slot = std::upper_bound(chunk->list, chunk->list + chunk->current_size, value, comp) - chunk->list;
+            if (chunk->current_size == N) {
+                Split(chunk_index);
+                if (slot > N / 2) {
+                    chunk_index++;
+                    slot -= N / 2;
+                }
+                chunk = chunks[chunk_index];
+            }
+            InsertAt(chunk, slot, value);
+            if (slot == 0) {
+                fences[chunk_index] = chunk->list[0];
+            }
+            size++;
+            return const_iterator(this, chunk_index, slot);
+        }
+
+        // removes one element equal to key, returns whether there was one
+        bool erase(const T& key) {
+            const_iterator found = find(key);
+            if (found == end()) {
+                return false;
+            }
+            erase(found);
+            return true;
+        }
+
+        // returns the iterator to the element after the erased one
+        const_iterator erase(const_iterator pos) {
+            size_type chunk_index = pos.chunk_index;
+            int slot = pos.slot;
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            std::move(chunk->list + slot + 1, chunk->list + chunk->current_size, chunk->list + slot);
+            chunk->current_size--;
+            chunk->list[chunk->current_size].~value_type();
+            size--;
+
+            if (chunk->current_size == 0) {
+                RemoveChunk(chunk_index);
+                return const_iterator(this, chunk_index, 0);
+            }
+            if (slot == 0) {
+                fences[chunk_index] = chunk->list[0];
+            }
+            if (chunk->current_size * 4 < N) {
+                if (chunk_index + 1 < chunks.size() && chunk->current_size + chunks[chunk_index + 1]->current_size <= N) {
+                    Merge(chunk_index);
+                }
+                else if (chunk_index > 0 && chunk->current_size + chunks[chunk_index - 1]->current_size <= N) {
+                    slot += chunks[chunk_index - 1]->current_size;
+                    chunk_index--;
+                    Merge(chunk_index);
+                }
+            }
+            return Normalize(chunk_index, slot);
+        }
+
+        void clear() noexcept {
+            for (auto chunk : chunks) {
+                ReleaseChunk(chunk);
+            }
+            chunks.clear();
+            fences.clear();
+            size = 0;
+        }
+
+        template <typename Function>
+        void for_each_chunk(Function f) const {
+            for (auto chunk : chunks) {
+                f(static_cast<const value_type*>(chunk->list), static_cast<size_type>(chunk->current_size));
+            }
+        }
+
+    private:
+        // last chunk whose fence is less than key (or not greater than it when after_equal is set), or 0
+        size_type FindChunk(const T& key, bool after_equal) const {
+            auto fence = after_equal
+                ? std::upper_bound(fences.begin() + 1, fences.end(), key, comp)
+                : std::lower_bound(fences.begin() + 1, fences.end(), key, comp);
+            return fence - fences.begin() - 1;
+        }
+
+        const_iterator Normalize(size_type chunk_index, int slot) const noexcept {
+            if (slot == chunks[chunk_index]->current_size) {
+                return const_iterator(this, chunk_index + 1, 0);
+            }
+            return const_iterator(this, chunk_index, slot);
+        }
+
+        void InsertAt(Chunk<value_type>* chunk, int slot, const T& value) {
+            int count = chunk->current_size;
+            if (slot == count) {
+                ::new (static_cast<void*>(chunk->list + count)) value_type(value);
+            }
+            else {
+                value_type copy(value);
+                ::new (static_cast<void*>(chunk->list + count)) value_type(std::move(chunk->list[count - 1]));
+                std::move_backward(chunk->list + slot, chunk->list + count - 1, chunk->list + count);
+                chunk->list[slot] = std::move(copy);
+            }
+            chunk->current_size++;
+        }
+
+        void AddChunk(size_type chunk_index, const T& fence) {
+            fences.insert(fences.begin() + chunk_index, fence);
+            Chunk<value_type>* chunk = nullptr;
+            try {
+                chunk = new Chunk<value_type>(N, allocator);
+                chunks.insert(chunks.begin() + chunk_index, chunk);
+            }
+            catch (...) {
+                if (chunk != nullptr) {
+                    ReleaseChunk(chunk);
+                }
+                fences.erase(fences.begin() + chunk_index);
+                throw;
+            }
+        }
+
+        void RemoveChunk(size_type chunk_index) {
+            ReleaseChunk(chunks[chunk_index]);
+            chunks.erase(chunks.begin() + chunk_index);
+            fences.erase(fences.begin() + chunk_index);
+        }
+
+        // moves the upper half of a full chunk into a new chunk right after it
+        void Split(size_type chunk_index) {
+            AddChunk(chunk_index + 1, chunks[chunk_index]->list[N / 2]);
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            Chunk<value_type>* new_chunk = chunks[chunk_index + 1];
+            std::uninitialized_copy(std::make_move_iterator(chunk->list + N / 2), std::make_move_iterator(chunk->list + N),
+                new_chunk->list);
+            for (int i = N / 2; i < N; i++) {
+                chunk->list[i].~value_type();
+            }
+            new_chunk->current_size = N - N / 2;
+            chunk->current_size = N / 2;
+        }
+
+        // moves all elements of the next chunk to the end of this one and drops the next chunk
+        void Merge(size_type chunk_index) {
+            Chunk<value_type>* chunk = chunks[chunk_index];
+            Chunk<value_type>* next = chunks[chunk_index + 1];
+            std::uninitialized_copy(std::make_move_iterator(next->list), std::make_move_iterator(next->list + next->current_size),
+                chunk->list + chunk->current_size);
+            chunk->current_size += next->current_size;
+            RemoveChunk(chunk_index + 1);
+        }
+
+        void ReleaseChunk(Chunk<value_type>* chunk) noexcept {
+            for (int i = 0; i < chunk->current_size; i++) {
+                chunk->list[i].~value_type();
+            }
+            chunk->allocator.deallocate(chunk->list, chunk->size);
+            delete chunk;
+        }
+    };
+}
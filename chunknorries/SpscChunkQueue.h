@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // Unbounded queue for exactly one producer and one consumer thread, both sides wait-free apart from
+    // allocating a segment. The producer publishes how many slots of its segment are written, the
+    // consumer keeps a local copy of that count and only reloads it once it has caught up. A consumed
+    // segment stays in the chain behind the consumer's current one and is taken back by the producer
+    // when it needs a new segment, so a steady pipeline stops allocating.
+    // The consumer can take a whole chunk at once through front_span and pop_span.
+    template <typename T, int N = 1024, typename Allocator = Allocator<T>>
+    class SpscChunkQueue {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+
+    private:
+        struct Segment {
+            Chunk<value_type> chunk;
+            std::atomic<int> written{ 0 };
+            std::atomic<Segment*> next{ nullptr };
+
+            explicit Segment(const Allocator& alloc) : chunk(N, alloc) {}
+        };
+
+        // touched by the producer only
+        struct alignas(64) ProducerSide {
+            Segment* tail = nullptr; //segment being written
+            int count = 0; //slots of tail that are written
+            Segment* first = nullptr; //oldest segment of the chain, reusable while it is not the consumer's
+            Segment* head_copy = nullptr; //last consumer segment the producer has seen
+        };
+
+        // touched by the consumer only, apart from head which the producer reads to find reusable segments
+        struct alignas(64) ConsumerSide {
+            std::atomic<Segment*> head{ nullptr }; //segment being read
+            int read = 0; //slots of head that are consumed
+            int available = 0; //written slots of head as last seen
+        };
+
+        ProducerSide producer;
+        ConsumerSide consumer;
+        Allocator allocator;
+
+    public:
+        explicit SpscChunkQueue(const Allocator& alloc = Allocator()) : allocator(alloc) {
+            Segment* segment = new Segment(allocator);
+            producer.tail = segment;
+            producer.first = segment;
+            producer.head_copy = segment;
+            consumer.head.store(segment, std::memory_order_relaxed);
+        }
+
+        SpscChunkQueue(const SpscChunkQueue& other) = delete;
+
+        SpscChunkQueue& operator=(const SpscChunkQueue& other) = delete;
+
+        ~SpscChunkQueue() {
+            Segment* segment = consumer.head.load(std::memory_order_relaxed);
+            int first_slot = consumer.read;
+            for (; segment != nullptr; segment = segment->next.load(std::memory_order_relaxed), first_slot = 0) {
+                int written = segment->written.load(std::memory_order_relaxed);
+                for (int i = first_slot; i < written; i++) {
+                    segment->chunk.list[i].~value_type();
+                }
+            }
+            while (producer.first != nullptr) {
+                Segment* next = producer.first->next.load(std::memory_order_relaxed);
+                ReleaseSegment(producer.first);
+                producer.first = next;
+            }
+        }
+
+        // producer side
+
+        void push(const T& value) {
+            emplace(value);
+        }
+
+        void push(T&& value) {
+            emplace(std::move(value));
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            if (producer.count == N) {
+                Segment* next = AcquireSegment();
+                producer.tail->next.store(next, std::memory_order_release);
+                producer.tail = next;
+                producer.count = 0;
+            }
+            ::new (static_cast<void*>(producer.tail->chunk.list + producer.count)) value_type(std::forward<Args>(args)...);
+            producer.count++;
+            producer.tail->written.store(producer.count, std::memory_order_release);
+        }
+
+        // consumer side
+
+        bool try_pop(T& value) {
+            value_type* values;
+            if (front_span(values) == 0) {
+                return false;
+            }
+            value = std::move(values[0]);
+            pop_span(1);
+            return true;
+        }
+
+        // points values at the readable elements of the current chunk and returns how many there are,
+        // 0 when the queue is empty; the elements stay in the queue until pop_span
+        size_type front_span(value_type*& values) {
+            Segment* head = consumer.head.load(std::memory_order_relaxed);
+            if (consumer.read == consumer.available) {
+                consumer.available = head->written.load(std::memory_order_acquire);
+                if (consumer.read == N) {
+                    Segment* next = head->next.load(std::memory_order_acquire);
+                    if (next == nullptr) {
+                        return 0;
+                    }
+                    // the finished segment becomes reusable for the producer
+                    consumer.head.store(next, std::memory_order_release);
+                    head = next;
+                    consumer.read = 0;
+                    consumer.available = head->written.load(std::memory_order_acquire);
+                }
+            }
+            values = head->chunk.list + consumer.read;
+            return consumer.available - consumer.read;
+        }
+
+        // removes the first count elements of the last front_span
+        void pop_span(size_type count) {
+            value_type* values = consumer.head.load(std::memory_order_relaxed)->chunk.list + consumer.read;
+            for (size_type i = 0; i < count; i++) {
+                values[i].~value_type();
+            }
+            consumer.read += static_cast<int>(count);
+        }
+
+        // calls f(values, count) on the readable elements of the current chunk and pops them,
+        // returns count
+        template <typename Function>
+        size_type consume_span(Function f) {
+            value_type* values;
+            size_type count = front_span(values);
+            if (count > 0) {
+                f(static_cast<const value_type*>(values), count);
+                pop_span(count);
+            }
+            return count;
+        }
+
+    private:
+        // reuses the oldest segment the consumer has left behind, or allocates one
+        Segment* AcquireSegment() {
+            if (producer.first == producer.head_copy) {
+                producer.head_copy = consumer.head.load(std::memory_order_acquire);
+            }
+            if (producer.first != producer.head_copy) {
+                Segment* segment = producer.first;
+                producer.first = segment->next.load(std::memory_order_relaxed);
+                segment->written.store(0, std::memory_order_relaxed);
+                segment->next.store(nullptr, std::memory_order_relaxed);
+                return segment;
+            }
+            return new Segment(allocator);
+        }
+
+        // the elements are already destroyed
+        void ReleaseSegment(Segment* segment) noexcept {
+            segment->chunk.allocator.deallocate(segment->chunk.list, segment->chunk.size);
+            delete segment;
+        }
+    };
+}
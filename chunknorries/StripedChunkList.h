@@ -0,0 +1,188 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // spin lock on its own cache line, for short critical sections
+    class alignas(64) StripeLock {
+    private:
+        std::atomic<bool> locked{ false };
+
+    public:
+        void lock() noexcept {
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        void unlock() noexcept {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    // ChunkList for many threads that mostly read and update single elements. Chunk i is guarded by
+    // stripe i % Stripes, so element operations only lock the stripe of their chunk; structural
+    // operations lock every stripe in order and so exclude all element operations.
+    // With Stripes = 1 this is the plain single-lock wrapper.
+    template <typename T, int N, int Stripes = 64, typename Allocator = Allocator<T>>
+    class StripedChunkList {
+        static_assert(Stripes >= 1, "at least one stripe is needed");
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using list_type = ChunkList<T, N, Allocator>;
+
+    private:
+        // holds every stripe, for structural operations
+        class AllStripes {
+        private:
+            const StripedChunkList& owner;
+
+        public:
+            explicit AllStripes(const StripedChunkList& list) noexcept : owner(list) {
+                for (auto& stripe : owner.stripes) {
+                    stripe.lock();
+                }
+            }
+
+            ~AllStripes() {
+                for (int i = Stripes - 1; i >= 0; i--) {
+                    owner.stripes[i].unlock();
+                }
+            }
+        };
+
+        list_type list;
+        std::vector<Chunk<value_type>*> chunks; //directory of the list's chunks
+        std::atomic<int> size{ 0 }; //copy of the list size, readable without a lock
+        mutable StripeLock stripes[Stripes];
+
+    public:
+        StripedChunkList() = default;
+
+        explicit StripedChunkList(const Allocator& alloc) : list(alloc) {}
+
+        StripedChunkList(const StripedChunkList& other) = delete;
+
+        StripedChunkList& operator=(const StripedChunkList& other) = delete;
+
+        // may be outdated by the time it returns if another thread changes the structure
+        int get_size() const noexcept {
+            return size.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept {
+            return get_size() == 0;
+        }
+
+        value_type load(size_type pos) const {
+            std::lock_guard<StripeLock> lock(GetStripe(pos));
+            return GetElement(pos);
+        }
+
+        void store(size_type pos, const T& value) {
+            std::lock_guard<StripeLock> lock(GetStripe(pos));
+            GetElement(pos) = value;
+        }
+
+        // calls f on the element while its chunk is locked and returns what f returns
+        template <typename Function>
+        auto update(size_type pos, Function f) -> decltype(f(std::declval<value_type&>())) {
+            std::lock_guard<StripeLock> lock(GetStripe(pos));
+            return f(GetElement(pos));
+        }
+
+        void push_back(const T& value) {
+            AllStripes lock(*this);
+            list.push_back(value);
+            SyncChunks();
+        }
+
+        void pop_back() {
+            AllStripes lock(*this);
+            list.pop_back();
+            SyncChunks();
+        }
+
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        void append(InputIt first, InputIt last) {
+            AllStripes lock(*this);
+            list.append(first, last);
+            SyncChunks();
+        }
+
+        void insert(size_type pos, const T& value) {
+            AllStripes lock(*this);
+            if (pos > static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            list.emplace(GetIterator(pos), value);
+            SyncChunks();
+        }
+
+        void erase(size_type pos) {
+            AllStripes lock(*this);
+            CheckPosition(pos);
+            list.erase(GetIterator(pos));
+            SyncChunks();
+        }
+
+        void clear() {
+            AllStripes lock(*this);
+            list.clear();
+            SyncChunks();
+        }
+
+        // calls f(list) with every stripe held, for whole-list reads such as iteration
+        template <typename Function>
+        void with_list(Function f) const {
+            AllStripes lock(*this);
+            f(list);
+        }
+
+    private:
+        // the stripe is chosen before it is held; that is safe because structural operations never
+        // move elements between chunks without holding every stripe, and the list has no head offset
+        StripeLock& GetStripe(size_type pos) const noexcept {
+            return stripes[(pos / N) % Stripes];
+        }
+
+        void CheckPosition(size_type pos) const {
+            if (pos >= static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+        }
+
+        value_type& GetElement(size_type pos) const {
+            CheckPosition(pos);
+            return chunks[pos / N]->list[pos % N];
+        }
+
+        void SyncChunks() {
+            size.store(list.size, std::memory_order_release);
+            size_type chunk_count = (list.size + N - 1) / N;
+            if (chunk_count < chunks.size()) {
+                chunks.resize(chunk_count);
+            }
+            while (chunks.size() < chunk_count) {
+                chunks.push_back(chunks.empty() ? list.start : chunks.back()->next);
+            }
+        }
+
+        typename list_type::const_iterator GetIterator(size_type pos) {
+            if (pos == static_cast<size_type>(list.size)) {
+                return list.cend();
+            }
+            typename list_type::const_iterator iterator = list.cbegin();
+            iterator += pos;
+            return iterator;
+        }
+    };
+}
@@ -0,0 +1,259 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include "Chunk.h"
+
+namespace chucknorries {
+    // ChunkList that keeps a Summary of every chunk, so queries can skip chunks the summary rules out.
+    // Appends and inserts add the new elements to the summaries right away, removals only mark them
+    // stale and they are rebuilt the next time a query reaches them. A summary may cover more values
+    // than its chunk holds, but never fewer.
+    // Summary needs a default constructor for an empty chunk, Add(value) and Rebuild(values, count).
+    // Elements are read-only from outside, writes go through set().
+    // Const queries may run concurrently with each other: the first one to reach a stale summary
+    // rebuilds it under a lock. Modifications need exclusive access, like for a ChunkList.
+    template <typename T, int N, typename Summary, typename Allocator = Allocator<T>>
+    class SummarizedChunkList {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using const_reference = const value_type&;
+        using list_type = ChunkList<T, N, Allocator>;
+
+    private:
+        struct Entry {
+            Summary summary;
+            std::atomic<bool> stale;
+
+            Entry() : stale(false) {}
+
+            Entry(const Summary& chunk_summary, bool is_stale) : summary(chunk_summary), stale(is_stale) {}
+
+            Entry(const Entry& other) : summary(other.summary), stale(other.stale.load(std::memory_order_relaxed)) {}
+
+            Entry& operator=(const Entry& other) {
+                summary = other.summary;
+                stale.store(other.stale.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return *this;
+            }
+        };
+
+        list_type list;
+        mutable std::deque<Entry> entries; //one per chunk, in list order
+        mutable std::mutex rebuild_mutex;
+
+    public:
+        SummarizedChunkList() = default;
+
+        explicit SummarizedChunkList(const Allocator& alloc) : list(alloc) {}
+
+        // a copied list starts at the first slot of its head chunk, so the summaries only carry over
+        // when the chunks of other line up with the copy
+        SummarizedChunkList(const SummarizedChunkList& other) : list(other.list) {
+            std::lock_guard<std::mutex> lock(other.rebuild_mutex);
+            if (list.HeadOffset() == other.list.HeadOffset()) {
+                entries = other.entries;
+            }
+            else {
+                entries.assign(GetChunkCount(), Entry(Summary(), true));
+            }
+        }
+
+        SummarizedChunkList(SummarizedChunkList&& other) : list(std::move(other.list)), entries(std::move(other.entries)) {
+            other.entries.clear();
+        }
+
+        SummarizedChunkList& operator=(const SummarizedChunkList& other) {
+            if (this != &other) {
+                SummarizedChunkList copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        SummarizedChunkList& operator=(SummarizedChunkList&& other) {
+            if (this != &other) {
+                list = std::move(other.list);
+                entries = std::move(other.entries);
+                other.entries.clear();
+            }
+            return *this;
+        }
+
+        int get_size() const noexcept {
+            return list.get_size();
+        }
+
+        bool empty() const noexcept {
+            return list.empty();
+        }
+
+        const list_type& get_list() const noexcept {
+            return list;
+        }
+
+        const_reference At(size_type pos) const {
+            return list.At(pos);
+        }
+
+        const_reference operator[](size_type pos) const {
+            return list[pos];
+        }
+
+        const_reference front() const {
+            return list.front();
+        }
+
+        const_reference back() const {
+            return list.back();
+        }
+
+        void push_back(const T& value) {
+            list.push_back(value);
+            if (entries.size() < GetChunkCount()) {
+                entries.emplace_back();
+            }
+            entries.back().summary.Add(value);
+        }
+
+        void push_front(const T& value) {
+            list.push_front(value);
+            if (entries.size() < GetChunkCount()) {
+                entries.emplace_front();
+            }
+            entries.front().summary.Add(value);
+        }
+
+        // the summaries of the appended chunks are built by the first query that reaches them
+        template <typename InputIt, typename = typename std::enable_if<IsInputIterator<InputIt>::value>::type>
+        void append(InputIt first, InputIt last) {
+            list.append(first, last);
+            if (!entries.empty()) {
+                entries.back().stale = true;
+            }
+            entries.resize(GetChunkCount(), Entry(Summary(), true));
+        }
+
+        // every chunk after pos receives the last element of the chunk before it
+        void insert(size_type pos, const T& value) {
+            if (pos > static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            list.emplace(GetIterator(pos), value);
+            size_type chunk_index = GetChunkIndex(pos);
+            Chunk<value_type>* temp_pointer = GetChunk(chunk_index);
+            if (chunk_index == entries.size()) {
+                entries.emplace_back();
+            }
+            entries[chunk_index].summary.Add(value);
+            for (size_type i = chunk_index + 1; i < GetChunkCount(); i++) {
+                temp_pointer = temp_pointer->next;
+                if (i == entries.size()) {
+                    entries.emplace_back();
+                }
+                entries[i].summary.Add(temp_pointer->list[0]);
+            }
+        }
+
+        void erase(size_type pos) {
+            if (pos >= static_cast<size_type>(list.size)) {
+                throw std::out_of_range("Position is out of range!");
+            }
+            size_type chunk_index = GetChunkIndex(pos);
+            list.erase(GetIterator(pos));
+            entries.resize(GetChunkCount());
+            for (size_type i = chunk_index; i < entries.size(); i++) {
+                entries[i].stale = true;
+            }
+        }
+
+        void pop_back() {
+            list.pop_back();
+            entries.resize(GetChunkCount());
+            if (!entries.empty()) {
+                entries.back().stale = true;
+            }
+        }
+
+        void pop_front() {
+            size_type chunk_count = GetChunkCount();
+            list.pop_front();
+            if (GetChunkCount() < chunk_count) {
+                entries.pop_front();
+            }
+            else if (!entries.empty()) {
+                entries.front().stale = true;
+            }
+        }
+
+        void set(size_type pos, const T& value) {
+            list.At(pos) = value;
+            Entry& entry = entries[GetChunkIndex(pos)];
+            entry.summary.Add(value);
+            entry.stale = true;
+        }
+
+        void clear() noexcept {
+            list.clear();
+            entries.clear();
+        }
+
+        // calls f(summary, values, count, position of values[0]) for every chunk in order until f returns
+        // false, rebuilding stale summaries on the way
+        template <typename Function>
+        void for_each_summary(Function f) const {
+            int position = 0;
+            size_type chunk_index = 0;
+            for (Chunk<value_type>* temp_pointer = list.start; temp_pointer != nullptr && temp_pointer->current_size > 0;
+                 temp_pointer = temp_pointer->next, chunk_index++) {
+                const value_type* values = temp_pointer->list + temp_pointer->offset;
+                int count = temp_pointer->current_size;
+                Entry& entry = entries[chunk_index];
+                if (entry.stale.load(std::memory_order_acquire)) {
+                    Rebuild(entry, values, count);
+                }
+                if (!f(static_cast<const Summary&>(entry.summary), values, count, position)) {
+                    return;
+                }
+                position += count;
+            }
+        }
+
+    private:
+        // queries running at the same time may reach the same stale entry, only the first rebuilds it
+        void Rebuild(Entry& entry, const value_type* values, int count) const {
+            std::lock_guard<std::mutex> lock(rebuild_mutex);
+            if (entry.stale.load(std::memory_order_relaxed)) {
+                entry.summary.Rebuild(values, count);
+                entry.stale.store(false, std::memory_order_release);
+            }
+        }
+
+        size_type GetChunkCount() const noexcept {
+            return list.size == 0 ? 0 : (list.HeadOffset() + list.size + N - 1) / N;
+        }
+
+        size_type GetChunkIndex(size_type pos) const noexcept {
+            return (pos + list.HeadOffset()) / N;
+        }
+
+        Chunk<value_type>* GetChunk(size_type chunk_index) const noexcept {
+            Chunk<value_type>* temp_pointer = list.start;
+            for (size_type i = 0; i < chunk_index; i++) {
+                temp_pointer = temp_pointer->next;
+            }
+            return temp_pointer;
+        }
+
+        typename list_type::const_iterator GetIterator(size_type pos) {
+            if (pos == static_cast<size_type>(list.size)) {
+                return list.cend();
+            }
+            typename list_type::const_iterator iterator = list.cbegin();
+            iterator += pos;
+            return iterator;
+        }
+    };
+}
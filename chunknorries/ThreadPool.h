@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace chucknorries {
+    class ThreadPool {
+    public:
+        using size_type = std::size_t;
+
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+    public:
+        explicit ThreadPool(size_type thread_count = std::max(2u, std::thread::hardware_concurrency()) - 1)
+        {
+            thread_count = std::max<size_type>(thread_count, 1);
+            for (size_type i = 0; i < thread_count; i++) {
+                workers.emplace_back([this] { WorkerLoop(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool& other) = delete;
+
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            condition.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        // pool shared by the parallel algorithms when no pool is passed explicitly
+        static ThreadPool& Default() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        size_type get_size() const noexcept {
+            return workers.size();
+        }
+
+        template <typename Function>
+        std::future<void> submit(Function f) {
+            auto task = std::make_shared<std::packaged_task<void()>>(std::move(f));
+            std::future<void> result = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.emplace([task] { (*task)(); });
+            }
+            condition.notify_one();
+            return result;
+        }
+
+        // splits [0, count) into one contiguous range per worker plus one for the calling thread
+        // and returns when f(first, last) has finished for all of them. While it waits the calling thread
+        // runs queued tasks, so f may itself call parallel_for on the same pool
+        template <typename Function>
+        void parallel_for(size_type count, Function f) {
+            if (count == 0) {
+                return;
+            }
+            size_type group_count = std::min(count, workers.size() + 1);
+            std::vector<std::future<void>> results;
+            results.reserve(group_count - 1);
+            for (size_type group = 1; group < group_count; group++) {
+                size_type first = count * group / group_count;
+                size_type last = count * (group + 1) / group_count;
+                results.push_back(submit([&f, first, last] { f(first, last); }));
+            }
+            std::exception_ptr error;
+            try {
+                f(0, count / group_count);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            for (auto& result : results) {
+                while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready && RunPendingTask()) {}
+                try {
+                    result.get();
+                }
+                catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        // returns false when there was nothing to run
+        bool RunPendingTask() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (tasks.empty()) {
+                    return false;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+            return true;
+        }
+
+        void WorkerLoop() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop();
+                }
+                task();
+            }
+        }
+    };
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <memory>
+#include "ThreadPool.h"
+
+namespace chucknorries {
+    // half-open range of indices that can give away its back half
+    struct SplittableRange {
+        std::size_t first = 0;
+        std::size_t last = 0;
+
+        std::size_t GetSize() const noexcept {
+            return last - first;
+        }
+
+        SplittableRange SplitBackHalf() noexcept {
+            std::size_t middle = first + GetSize() / 2;
+            SplittableRange back_half{ middle, last };
+            last = middle;
+            return back_half;
+        }
+    };
+
+    // per-worker deque of ranges: the owner takes single indices from the front,
+    // thieves take the back half of the last range
+    class WorkStealingQueue {
+    private:
+        std::deque<SplittableRange> ranges;
+        std::mutex mutex;
+
+    public:
+        void Push(SplittableRange range) {
+            if (range.GetSize() == 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ranges.push_back(range);
+        }
+
+        bool PopFront(std::size_t& index) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ranges.empty()) {
+                return false;
+            }
+            index = ranges.front().first++;
+            if (ranges.front().GetSize() == 0) {
+                ranges.pop_front();
+            }
+            return true;
+        }
+
+        bool StealHalf(SplittableRange& stolen) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ranges.empty()) {
+                return false;
+            }
+            if (ranges.size() > 1 || ranges.back().GetSize() == 1) {
+                stolen = ranges.back();
+                ranges.pop_back();
+                return true;
+            }
+            stolen = ranges.back().SplitBackHalf();
+            return true;
+        }
+    };
+
+    class WorkStealingExecutor {
+    public:
+        using size_type = std::size_t;
+
+    private:
+        ThreadPool& pool;
+
+    public:
+        explicit WorkStealingExecutor(ThreadPool& custom_pool = ThreadPool::Default()) : pool(custom_pool) {}
+
+        // calls f(index, index + 1) for every index in [0, count); each worker starts with an equal share
+        // and idle workers steal half of the remaining range of another one
+        template <typename Function>
+        void parallel_for(size_type count, Function f) {
+            if (count == 0) {
+                return;
+            }
+            size_type worker_count = std::min(count, pool.get_size() + 1);
+            std::unique_ptr<WorkStealingQueue[]> queues(new WorkStealingQueue[worker_count]);
+            for (size_type worker = 0; worker < worker_count; worker++) {
+                queues[worker].Push({ count * worker / worker_count, count * (worker + 1) / worker_count });
+            }
+
+            std::atomic<size_type> remaining(count);
+            std::atomic<bool> failed(false);
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            auto work = [&](size_type worker) {
+                size_type victim = worker;
+                while (remaining.load(std::memory_order_acquire) > 0 && !failed.load(std::memory_order_relaxed)) {
+                    size_type index = 0;
+                    if (queues[worker].PopFront(index)) {
+                        try {
+                            f(index, index + 1);
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> lock(error_mutex);
+                            if (!error) {
+                                error = std::current_exception();
+                            }
+                            failed.store(true, std::memory_order_relaxed);
+                        }
+                        remaining.fetch_sub(1, std::memory_order_acq_rel);
+                        continue;
+                    }
+                    SplittableRange stolen;
+                    victim = (victim + 1) % worker_count;
+                    if (victim != worker && queues[victim].StealHalf(stolen)) {
+                        queues[worker].Push(stolen);
+                    }
+                    else if (victim == worker) {
+                        std::this_thread::yield();
+                    }
+                }
+            };
+
+            pool.parallel_for(worker_count, [&work](size_type first, size_type last) {
+                for (size_type worker = first; worker < last; worker++) {
+                    work(worker);
+                }
+            });
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+}
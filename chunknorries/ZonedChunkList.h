@@ -0,0 +1,102 @@
+#pragma once
+#include "SummarizedChunkList.h"
+
+namespace chucknorries {
+    // smallest and largest value of a chunk
+    template <typename T>
+    struct ZoneSummary {
+        T min = T();
+        T max = T();
+        bool empty = true;
+
+        void Add(const T& value) {
+            if (empty || value < min) {
+                min = value;
+            }
+            if (empty || max < value) {
+                max = value;
+            }
+            empty = false;
+        }
+
+        void Rebuild(const T* values, int count) {
+            empty = true;
+            for (int i = 0; i < count; i++) {
+                Add(values[i]);
+            }
+        }
+
+        bool Overlaps(const T& low, const T& high) const {
+            return !empty && !(max < low) && !(high < min);
+        }
+    };
+
+    // ChunkList with zone maps: range queries skip every chunk whose [min, max] cannot meet the range
+    template <typename T, int N, typename Allocator = Allocator<T>>
+    class ZonedChunkList : public SummarizedChunkList<T, N, ZoneSummary<T>, Allocator> {
+    private:
+        using base = SummarizedChunkList<T, N, ZoneSummary<T>, Allocator>;
+
+    public:
+        using typename base::value_type;
+        using typename base::size_type;
+
+        using base::base;
+
+        // position of the first element in [low, high], or -1
+        int find_first_in(const T& low, const T& high) const {
+            int position = -1;
+            ForEachCandidate(low, high, [&](const value_type* values, int count, int first_position) {
+                for (int i = 0; i < count && position < 0; i++) {
+                    if (!(values[i] < low) && !(high < values[i])) {
+                        position = first_position + i;
+                    }
+                }
+                return position < 0;
+            });
+            return position;
+        }
+
+        size_type count_in(const T& low, const T& high) const {
+            size_type count_found = 0;
+            ForEachCandidate(low, high, [&](const value_type* values, int count, int) {
+                for (int i = 0; i < count; i++) {
+                    count_found += !(values[i] < low) && !(high < values[i]);
+                }
+                return true;
+            });
+            return count_found;
+        }
+
+        // calls f on every element in [low, high], in list order
+        template <typename Function>
+        void for_each_in(const T& low, const T& high, Function f) const {
+            ForEachCandidate(low, high, [&](const value_type* values, int count, int) {
+                for (int i = 0; i < count; i++) {
+                    if (!(values[i] < low) && !(high < values[i])) {
+                        f(values[i]);
+                    }
+                }
+                return true;
+            });
+        }
+
+        // number of chunks a query for [low, high] has to scan
+        size_type count_candidate_chunks(const T& low, const T& high) const {
+            size_type candidates = 0;
+            ForEachCandidate(low, high, [&candidates](const value_type*, int, int) {
+                candidates++;
+                return true;
+            });
+            return candidates;
+        }
+
+    private:
+        template <typename Function>
+        void ForEachCandidate(const T& low, const T& high, Function f) const {
+            this->for_each_summary([&](const ZoneSummary<T>& zone, const value_type* values, int count, int position) {
+                return !zone.Overlaps(low, high) || f(values, count, position);
+            });
+        }
+    };
+}